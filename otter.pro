@@ -13,17 +13,29 @@ SOURCES += src/main.cpp \
     src/core/ActionsManager.cpp \
     src/core/AddressCompletionModel.cpp \
     src/core/Application.cpp \
+    src/core/BlockedNetworkReply.cpp \
+    src/core/BookmarksImporter.cpp \
     src/core/BookmarksManager.cpp \
+    src/core/BookmarksWriter.cpp \
+    src/core/ContentBlockingManager.cpp \
     src/core/CookieJar.cpp \
     src/core/FileSystemCompleterModel.cpp \
     src/core/HistoryManager.cpp \
     src/core/LocalListingNetworkReply.cpp \
+    src/core/LocalListingThread.cpp \
+    src/core/LocalTextNetworkReply.cpp \
     src/core/NetworkAccessManager.cpp \
     src/core/NetworkCache.cpp \
+    src/core/PreconnectManager.cpp \
+    src/core/PrefetchManager.cpp \
+    src/core/ResourceNetworkReply.cpp \
+    src/core/ScheduledNetworkReply.cpp \
     src/core/SearchesManager.cpp \
     src/core/SearchSuggester.cpp \
     src/core/SessionsManager.cpp \
     src/core/SettingsManager.cpp \
+    src/core/SnapshotNetworkReply.cpp \
+    src/core/SnapshotsManager.cpp \
     src/core/TransfersManager.cpp \
     src/core/Utils.cpp \
     src/core/WebBackend.cpp \
@@ -62,6 +74,8 @@ SOURCES += src/main.cpp \
     src/modules/windows/configuration/ConfigurationContentsWidget.cpp \
     src/modules/windows/cookies/CookiesContentsWidget.cpp \
     src/modules/windows/history/HistoryContentsWidget.cpp \
+    src/modules/windows/network/NetworkContentsWidget.cpp \
+    src/modules/windows/network/NetworkTimelineDelegate.cpp \
     src/modules/windows/transfers/ProgressBarDelegate.cpp \
     src/modules/windows/transfers/TransfersContentsWidget.cpp \
     src/modules/windows/web/ImagePropertiesDialog.cpp \
@@ -71,17 +85,29 @@ SOURCES += src/main.cpp \
 HEADERS += src/core/ActionsManager.h \
     src/core/AddressCompletionModel.h \
     src/core/Application.h \
+    src/core/BlockedNetworkReply.h \
+    src/core/BookmarksImporter.h \
     src/core/BookmarksManager.h \
+    src/core/BookmarksWriter.h \
+    src/core/ContentBlockingManager.h \
     src/core/CookieJar.h \
     src/core/FileSystemCompleterModel.h \
     src/core/HistoryManager.h \
     src/core/LocalListingNetworkReply.h \
+    src/core/LocalListingThread.h \
+    src/core/LocalTextNetworkReply.h \
     src/core/NetworkAccessManager.h \
     src/core/NetworkCache.h \
+    src/core/PreconnectManager.h \
+    src/core/PrefetchManager.h \
+    src/core/ResourceNetworkReply.h \
+    src/core/ScheduledNetworkReply.h \
     src/core/SearchesManager.h \
     src/core/SearchSuggester.h \
     src/core/SessionsManager.h \
     src/core/SettingsManager.h \
+    src/core/SnapshotNetworkReply.h \
+    src/core/SnapshotsManager.h \
     src/core/TransfersManager.h \
     src/core/Utils.h \
     src/core/WebBackend.h \
@@ -120,6 +146,8 @@ HEADERS += src/core/ActionsManager.h \
     src/modules/windows/configuration/ConfigurationContentsWidget.h \
     src/modules/windows/cookies/CookiesContentsWidget.h \
     src/modules/windows/history/HistoryContentsWidget.h \
+    src/modules/windows/network/NetworkContentsWidget.h \
+    src/modules/windows/network/NetworkTimelineDelegate.h \
     src/modules/windows/transfers/ProgressBarDelegate.h \
     src/modules/windows/transfers/TransfersContentsWidget.h \
     src/modules/windows/web/ImagePropertiesDialog.h \
@@ -141,6 +169,7 @@ FORMS += src/ui/AuthenticationDialog.ui \
     src/modules/windows/configuration/ConfigurationContentsWidget.ui \
     src/modules/windows/cookies/CookiesContentsWidget.ui \
     src/modules/windows/history/HistoryContentsWidget.ui \
+    src/modules/windows/network/NetworkContentsWidget.ui \
     src/modules/windows/transfers/TransfersContentsWidget.ui \
     src/modules/windows/web/ImagePropertiesDialog.ui \
     src/modules/windows/web/WebContentsWidget.ui
@@ -23,17 +23,22 @@
 
 #include <QtCore/QCoreApplication>
 
+#include <algorithm>
+
 namespace Otter
 {
 
 AddressCompletionModel* AddressCompletionModel::m_instance = NULL;
 
 AddressCompletionModel::AddressCompletionModel(QObject *parent) : QAbstractListModel(parent),
-	m_updateTimer(0)
+	m_updateTimer(0),
+	m_needsReset(true)
 {
+	m_specialUrls << QLatin1String("about:bookmarks") << QLatin1String("about:cache") << QLatin1String("about:config") << QLatin1String("about:cookies") << QLatin1String("about:history") << QLatin1String("about:network") << QLatin1String("about:transfers");
 	m_updateTimer = startTimer(250);
 
-	connect(BookmarksManager::getInstance(), SIGNAL(folderModified(int)), this, SLOT(updateCompletion()));
+	connect(BookmarksManager::getInstance(), SIGNAL(urlAdded(QString)), this, SLOT(addUrl(QString)));
+	connect(BookmarksManager::getInstance(), SIGNAL(urlRemoved(QString)), this, SLOT(removeUrl(QString)));
 	connect(SettingsManager::getInstance(), SIGNAL(valueChanged(QString,QVariant)), this, SLOT(optionChanged(QString)));
 }
 
@@ -45,15 +50,94 @@ void AddressCompletionModel::timerEvent(QTimerEvent *event)
 
 		m_updateTimer = 0;
 
-		QStringList urls;
-		urls << QLatin1String("about:bookmarks") << QLatin1String("about:cache") << QLatin1String("about:config") << QLatin1String("about:cookies") << QLatin1String("about:history") << QLatin1String("about:transfers");
-		urls << BookmarksManager::getUrls();
+		if (m_needsReset)
+		{
+			const QStringList bookmarks = BookmarksManager::getUrls();
+			QStringList urls = m_specialUrls;
+
+			for (int i = 0; i < bookmarks.count(); ++i)
+			{
+				if (!m_specialUrls.contains(bookmarks.at(i)))
+				{
+					urls.append(bookmarks.at(i));
+				}
+			}
+
+			beginResetModel();
+
+			m_urls = urls;
+			m_rows.clear();
+			m_needsReset = false;
+
+			for (int i = m_specialUrls.count(); i < m_urls.count(); ++i)
+			{
+				m_rows[m_urls.at(i)] = i;
+			}
+
+			endResetModel();
+
+			m_addedUrls.clear();
+			m_removedUrls.clear();
+
+			return;
+		}
+
+		QSet<QString>::const_iterator iterator;
+		QList<int> removedRows;
+
+		for (iterator = m_removedUrls.constBegin(); iterator != m_removedUrls.constEnd(); ++iterator)
+		{
+			if (m_rows.contains(*iterator))
+			{
+				removedRows.append(m_rows.take(*iterator));
+			}
+		}
 
-		beginResetModel();
+		if (!removedRows.isEmpty())
+		{
+			std::sort(removedRows.begin(), removedRows.end());
 
-		m_urls = urls;
+			for (int i = (removedRows.count() - 1); i >= 0; --i)
+			{
+				beginRemoveRows(QModelIndex(), removedRows.at(i), removedRows.at(i));
 
-		endResetModel();
+				m_urls.removeAt(removedRows.at(i));
+
+				endRemoveRows();
+			}
+
+			for (int i = removedRows.first(); i < m_urls.count(); ++i)
+			{
+				m_rows[m_urls.at(i)] = i;
+			}
+		}
+
+		QStringList addedUrls;
+
+		for (iterator = m_addedUrls.constBegin(); iterator != m_addedUrls.constEnd(); ++iterator)
+		{
+			if (!m_rows.contains(*iterator) && !m_specialUrls.contains(*iterator))
+			{
+				addedUrls.append(*iterator);
+			}
+		}
+
+		if (!addedUrls.isEmpty())
+		{
+			beginInsertRows(QModelIndex(), m_urls.count(), (m_urls.count() + addedUrls.count() - 1));
+
+			for (int i = 0; i < addedUrls.count(); ++i)
+			{
+				m_rows[addedUrls.at(i)] = m_urls.count();
+
+				m_urls.append(addedUrls.at(i));
+			}
+
+			endInsertRows();
+		}
+
+		m_addedUrls.clear();
+		m_removedUrls.clear();
 	}
 }
 
@@ -65,8 +149,36 @@ void AddressCompletionModel::optionChanged(const QString &option)
 	}
 }
 
+void AddressCompletionModel::addUrl(const QString &url)
+{
+	if (!m_removedUrls.remove(url))
+	{
+		m_addedUrls.insert(url);
+	}
+
+	if (m_updateTimer == 0)
+	{
+		m_updateTimer = startTimer(250);
+	}
+}
+
+void AddressCompletionModel::removeUrl(const QString &url)
+{
+	if (!m_addedUrls.remove(url))
+	{
+		m_removedUrls.insert(url);
+	}
+
+	if (m_updateTimer == 0)
+	{
+		m_updateTimer = startTimer(250);
+	}
+}
+
 void AddressCompletionModel::updateCompletion()
 {
+	m_needsReset = true;
+
 	if (m_updateTimer == 0)
 	{
 		m_updateTimer = startTimer(250);
@@ -21,6 +21,8 @@
 #define OTTER_ADDRESSCOMPLETIONMODEL_H
 
 #include <QtCore/QAbstractListModel>
+#include <QtCore/QHash>
+#include <QtCore/QSet>
 
 namespace Otter
 {
@@ -40,13 +42,20 @@ protected:
 
 protected slots:
 	void optionChanged(const QString &option);
+	void addUrl(const QString &url);
+	void removeUrl(const QString &url);
 	void updateCompletion();
 
 private:
 	explicit AddressCompletionModel(QObject *parent = NULL);
 
+	QStringList m_specialUrls;
 	QStringList m_urls;
+	QHash<QString, int> m_rows;
+	QSet<QString> m_addedUrls;
+	QSet<QString> m_removedUrls;
 	int m_updateTimer;
+	bool m_needsReset;
 
 	static AddressCompletionModel *m_instance;
 };
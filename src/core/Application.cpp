@@ -20,9 +20,13 @@
 #include "Application.h"
 #include "ActionsManager.h"
 #include "BookmarksManager.h"
+#include "ContentBlockingManager.h"
 #include "HistoryManager.h"
+#include "PreconnectManager.h"
+#include "PrefetchManager.h"
 #include "SearchesManager.h"
 #include "SettingsManager.h"
+#include "SnapshotsManager.h"
 #include "TransfersManager.h"
 #include "WebBackendsManager.h"
 #include "../ui/MainWindow.h"
@@ -167,6 +171,14 @@ Application::Application(int &argc, char **argv) : QApplication(argc, argv),
 
 	HistoryManager::createInstance(this);
 
+	PreconnectManager::createInstance(this);
+
+	PrefetchManager::createInstance(this);
+
+	ContentBlockingManager::createInstance(this);
+
+	SnapshotsManager::createInstance(this);
+
 	WebBackendsManager::createInstance(this);
 
 	SearchesManager::createInstance(this);
@@ -0,0 +1,61 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2013 - 2014 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "BlockedNetworkReply.h"
+
+#include <QtCore/QTimer>
+
+namespace Otter
+{
+
+BlockedNetworkReply::BlockedNetworkReply(QObject *parent, const QNetworkRequest &request, QNetworkAccessManager::Operation operation) : QNetworkReply(parent)
+{
+	setRequest(request);
+	setUrl(request.url());
+	setOperation(operation);
+	setError(ContentAccessDenied, tr("Request blocked by content blocking rules"));
+
+	open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+
+	QTimer::singleShot(0, this, SIGNAL(finished()));
+}
+
+void BlockedNetworkReply::abort()
+{
+}
+
+qint64 BlockedNetworkReply::bytesAvailable() const
+{
+	return 0;
+}
+
+qint64 BlockedNetworkReply::readData(char *data, qint64 maxSize)
+{
+	Q_UNUSED(data)
+	Q_UNUSED(maxSize)
+
+	return -1;
+}
+
+bool BlockedNetworkReply::isSequential() const
+{
+	return true;
+}
+
+}
@@ -0,0 +1,355 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2013 - 2014 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "BookmarksImporter.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QRegularExpression>
+#include <QtCore/QStack>
+#include <QtCore/QTextStream>
+
+namespace Otter
+{
+
+BookmarksImporter::BookmarksImporter(const QString &path, int folder, QObject *parent) : QThread(parent),
+	m_path(path),
+	m_folder(folder)
+{
+}
+
+BookmarksImporter::~BookmarksImporter()
+{
+	wait();
+
+	deleteBookmarks(m_bookmarks);
+}
+
+void BookmarksImporter::run()
+{
+	QFile file(m_path);
+
+	if (!file.open(QFile::ReadOnly))
+	{
+		return;
+	}
+
+	const QByteArray header = file.peek(1024);
+	const QString suffix = QFileInfo(m_path).suffix().toLower();
+
+	if (header.contains("<xbel") || header.contains("DOCTYPE xbel") || suffix == QLatin1String("xbel"))
+	{
+		readXbel(&file);
+	}
+	else if (header.contains("NETSCAPE-Bookmark-file") || suffix == QLatin1String("html") || suffix == QLatin1String("htm"))
+	{
+		readHtml(&file);
+	}
+	else if (header.trimmed().startsWith('{') || suffix == QLatin1String("json"))
+	{
+		readJson(&file);
+	}
+}
+
+void BookmarksImporter::readXbel(QIODevice *device)
+{
+	QXmlStreamReader reader(device);
+
+	if (reader.readNextStartElement() && reader.name() == QLatin1String("xbel") && reader.attributes().value(QLatin1String("version")).toString() == QLatin1String("1.0"))
+	{
+		while (reader.readNextStartElement())
+		{
+			if (reader.name() == QLatin1String("folder") || reader.name() == QLatin1String("bookmark") || reader.name() == QLatin1String("separator"))
+			{
+				m_bookmarks.append(readXbelBookmark(&reader));
+			}
+			else
+			{
+				reader.skipCurrentElement();
+			}
+		}
+	}
+}
+
+void BookmarksImporter::readHtml(QIODevice *device)
+{
+	const QRegularExpression tagExpression(QLatin1String("<(/?DL|HR|H3|A|DD)\\b([^>]*)>([^<]*)"), QRegularExpression::CaseInsensitiveOption);
+	const QRegularExpression urlExpression(QLatin1String("HREF\\s*=\\s*\"([^\"]*)\""), QRegularExpression::CaseInsensitiveOption);
+	QStack<BookmarkInformation*> folders;
+	BookmarkInformation *folder = NULL;
+	BookmarkInformation *pendingFolder = NULL;
+	BookmarkInformation *lastBookmark = NULL;
+	QTextStream stream(device);
+	stream.setCodec("UTF-8");
+
+	while (!stream.atEnd())
+	{
+		QRegularExpressionMatchIterator iterator = tagExpression.globalMatch(stream.readLine());
+
+		while (iterator.hasNext())
+		{
+			const QRegularExpressionMatch match = iterator.next();
+			const QString tag = match.captured(1).toUpper();
+
+			if (tag == QLatin1String("DL"))
+			{
+				folders.push(folder);
+
+				if (pendingFolder)
+				{
+					folder = pendingFolder;
+					pendingFolder = NULL;
+				}
+
+				continue;
+			}
+
+			if (tag == QLatin1String("/DL"))
+			{
+				folder = (folders.isEmpty() ? NULL : folders.pop());
+				pendingFolder = NULL;
+
+				continue;
+			}
+
+			if (tag == QLatin1String("DD"))
+			{
+				if (lastBookmark)
+				{
+					lastBookmark->description = decodeEntities(match.captured(3).trimmed());
+				}
+
+				continue;
+			}
+
+			BookmarkInformation *bookmark = new BookmarkInformation();
+
+			if (tag == QLatin1String("H3"))
+			{
+				bookmark->type = FolderBookmark;
+				bookmark->title = decodeEntities(match.captured(3).trimmed());
+
+				pendingFolder = bookmark;
+			}
+			else if (tag == QLatin1String("A"))
+			{
+				bookmark->type = UrlBookmark;
+				bookmark->url = decodeEntities(urlExpression.match(match.captured(2)).captured(1));
+				bookmark->title = decodeEntities(match.captured(3).trimmed());
+			}
+			else
+			{
+				bookmark->type = SeparatorBookmark;
+			}
+
+			if (folder)
+			{
+				folder->children.append(bookmark);
+			}
+			else
+			{
+				m_bookmarks.append(bookmark);
+			}
+
+			lastBookmark = bookmark;
+		}
+	}
+}
+
+void BookmarksImporter::readJson(QIODevice *device)
+{
+	const QJsonObject root = QJsonDocument::fromJson(device->readAll()).object();
+
+	if (root.contains(QLatin1String("roots")))
+	{
+		const QJsonObject roots = root.value(QLatin1String("roots")).toObject();
+		QJsonObject::const_iterator iterator;
+
+		for (iterator = roots.constBegin(); iterator != roots.constEnd(); ++iterator)
+		{
+			if (iterator.value().isObject())
+			{
+				m_bookmarks.append(readJsonBookmark(iterator.value().toObject()));
+			}
+		}
+	}
+	else
+	{
+		const QJsonArray children = root.value(QLatin1String("children")).toArray();
+
+		for (int i = 0; i < children.count(); ++i)
+		{
+			m_bookmarks.append(readJsonBookmark(children.at(i).toObject()));
+		}
+	}
+}
+
+void BookmarksImporter::deleteBookmarks(const QList<BookmarkInformation*> &bookmarks)
+{
+	for (int i = 0; i < bookmarks.count(); ++i)
+	{
+		deleteBookmarks(bookmarks.at(i)->children);
+
+		delete bookmarks.at(i);
+	}
+}
+
+QList<BookmarkInformation*> BookmarksImporter::takeBookmarks()
+{
+	const QList<BookmarkInformation*> bookmarks = m_bookmarks;
+
+	m_bookmarks.clear();
+
+	return bookmarks;
+}
+
+QString BookmarksImporter::getPath() const
+{
+	return m_path;
+}
+
+QString BookmarksImporter::decodeEntities(const QString &text)
+{
+	if (!text.contains(QLatin1Char('&')))
+	{
+		return text;
+	}
+
+	QString result = text;
+	result.replace(QLatin1String("&lt;"), QLatin1String("<"));
+	result.replace(QLatin1String("&gt;"), QLatin1String(">"));
+	result.replace(QLatin1String("&quot;"), QLatin1String("\""));
+	result.replace(QLatin1String("&#39;"), QLatin1String("'"));
+	result.replace(QLatin1String("&amp;"), QLatin1String("&"));
+
+	return result;
+}
+
+BookmarkInformation* BookmarksImporter::readXbelBookmark(QXmlStreamReader *reader)
+{
+	BookmarkInformation *bookmark = new BookmarkInformation();
+
+	if (reader->name() == QLatin1String("folder"))
+	{
+		bookmark->type = FolderBookmark;
+
+		while (reader->readNext())
+		{
+			if (reader->isStartElement())
+			{
+				if (reader->name() == QLatin1String("title"))
+				{
+					bookmark->title = reader->readElementText().trimmed();
+				}
+				else if (reader->name() == QLatin1String("desc"))
+				{
+					bookmark->description = reader->readElementText().trimmed();
+				}
+				else if (reader->name() == QLatin1String("folder") || reader->name() == QLatin1String("bookmark") || reader->name() == QLatin1String("separator"))
+				{
+					bookmark->children.append(readXbelBookmark(reader));
+				}
+				else
+				{
+					reader->skipCurrentElement();
+				}
+			}
+			else if (reader->isEndElement() && reader->name() == QLatin1String("folder"))
+			{
+				break;
+			}
+		}
+	}
+	else if (reader->name() == QLatin1String("bookmark"))
+	{
+		bookmark->type = UrlBookmark;
+		bookmark->url = reader->attributes().value(QLatin1String("href")).toString();
+
+		while (reader->readNext())
+		{
+			if (reader->isStartElement())
+			{
+				if (reader->name() == QLatin1String("title"))
+				{
+					bookmark->title = reader->readElementText().trimmed();
+				}
+				else if (reader->name() == QLatin1String("desc"))
+				{
+					bookmark->description = reader->readElementText().trimmed();
+				}
+				else
+				{
+					reader->skipCurrentElement();
+				}
+			}
+			else if (reader->isEndElement() && reader->name() == QLatin1String("bookmark"))
+			{
+				break;
+			}
+		}
+	}
+	else if (reader->name() == QLatin1String("separator"))
+	{
+		bookmark->type = SeparatorBookmark;
+
+		reader->readNext();
+	}
+
+	return bookmark;
+}
+
+BookmarkInformation* BookmarksImporter::readJsonBookmark(const QJsonObject &object)
+{
+	BookmarkInformation *bookmark = new BookmarkInformation();
+	const QString type = object.value(QLatin1String("type")).toString();
+
+	bookmark->title = (object.contains(QLatin1String("name")) ? object.value(QLatin1String("name")) : object.value(QLatin1String("title"))).toString();
+
+	if (type == QLatin1String("url") || type == QLatin1String("text/x-moz-place"))
+	{
+		bookmark->type = UrlBookmark;
+		bookmark->url = (object.contains(QLatin1String("url")) ? object.value(QLatin1String("url")) : object.value(QLatin1String("uri"))).toString();
+	}
+	else if (type == QLatin1String("text/x-moz-place-separator"))
+	{
+		bookmark->type = SeparatorBookmark;
+	}
+	else
+	{
+		const QJsonArray children = object.value(QLatin1String("children")).toArray();
+
+		bookmark->type = FolderBookmark;
+
+		for (int i = 0; i < children.count(); ++i)
+		{
+			bookmark->children.append(readJsonBookmark(children.at(i).toObject()));
+		}
+	}
+
+	return bookmark;
+}
+
+int BookmarksImporter::getFolder() const
+{
+	return m_folder;
+}
+
+}
@@ -0,0 +1,61 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2013 - 2014 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_BOOKMARKSIMPORTER_H
+#define OTTER_BOOKMARKSIMPORTER_H
+
+#include "BookmarksManager.h"
+
+#include <QtCore/QJsonObject>
+#include <QtCore/QThread>
+
+namespace Otter
+{
+
+class BookmarksImporter : public QThread
+{
+	Q_OBJECT
+
+public:
+	explicit BookmarksImporter(const QString &path, int folder = 0, QObject *parent = NULL);
+	~BookmarksImporter();
+
+	QList<BookmarkInformation*> takeBookmarks();
+	QString getPath() const;
+	int getFolder() const;
+
+protected:
+	void run();
+	void readXbel(QIODevice *device);
+	void readHtml(QIODevice *device);
+	void readJson(QIODevice *device);
+	static void deleteBookmarks(const QList<BookmarkInformation*> &bookmarks);
+	BookmarkInformation* readXbelBookmark(QXmlStreamReader *reader);
+	BookmarkInformation* readJsonBookmark(const QJsonObject &object);
+	static QString decodeEntities(const QString &text);
+
+private:
+	QString m_path;
+	QList<BookmarkInformation*> m_bookmarks;
+	int m_folder;
+};
+
+}
+
+#endif
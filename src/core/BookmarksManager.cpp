@@ -18,11 +18,14 @@
 **************************************************************************/
 
 #include "BookmarksManager.h"
+#include "BookmarksImporter.h"
+#include "BookmarksWriter.h"
 #include "SettingsManager.h"
+#include "Utils.h"
 
 #include <QtCore/QFile>
-#include <QtCore/QSet>
 #include <QtCore/QTimer>
+#include <QtCore/QTimerEvent>
 #include <QtCore/QUrl>
 
 namespace Otter
@@ -30,117 +33,231 @@ namespace Otter
 
 BookmarksManager* BookmarksManager::m_instance = NULL;
 QList<BookmarkInformation*> BookmarksManager::m_bookmarks;
-QList<BookmarkInformation*> BookmarksManager::m_allBookmarks;
 QHash<int, BookmarkInformation*> BookmarksManager::m_pointers;
-QSet<QString> BookmarksManager::m_urls;
+QHash<int, QString> BookmarksManager::m_indexedUrls;
+QMultiHash<quint64, BookmarkInformation*> BookmarksManager::m_urls;
 int BookmarksManager::m_identifier;
 
-BookmarksManager::BookmarksManager(QObject *parent) : QObject(parent)
+BookmarksManager::BookmarksManager(QObject *parent) : QObject(parent),
+	m_loader(NULL),
+	m_writer(NULL),
+	m_saveTimer(0)
 {
 	QTimer::singleShot(250, this, SLOT(load()));
 }
 
 BookmarksManager::~BookmarksManager()
 {
-	for (int i = 0; i < m_bookmarks.count(); ++i)
+	if (m_saveTimer != 0)
 	{
-		deleteBookmark(m_bookmarks.at(i), false);
+		killTimer(m_saveTimer);
+
+		m_saveTimer = 0;
+
+		if (!m_loader)
+		{
+			if (m_writer)
+			{
+				m_writer->wait();
+			}
+
+			save();
+		}
+	}
+
+	const QList<BookmarksImporter*> importers = findChildren<BookmarksImporter*>();
+
+	for (int i = 0; i < importers.count(); ++i)
+	{
+		importers.at(i)->wait();
+	}
+
+	const QList<BookmarksWriter*> writers = findChildren<BookmarksWriter*>();
+
+	for (int i = 0; i < writers.count(); ++i)
+	{
+		writers.at(i)->wait();
+	}
+
+	qDeleteAll(m_pointers);
+
+	m_pointers.clear();
+	m_indexedUrls.clear();
+	m_bookmarks.clear();
+	m_urls.clear();
+}
+
+void BookmarksManager::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() == m_saveTimer && !m_loader && !m_writer)
+	{
+		killTimer(m_saveTimer);
+
+		m_saveTimer = 0;
+
+		save();
+	}
+}
+
+void BookmarksManager::scheduleSave()
+{
+	if (m_saveTimer == 0)
+	{
+		m_saveTimer = startTimer(1000);
 	}
 }
 
 void BookmarksManager::load()
 {
-	m_bookmarks.clear();
-	m_identifier = 0;
+	m_loader = new BookmarksImporter((SettingsManager::getPath() + QLatin1String("/bookmarks.xbel")), 0, this);
+
+	connect(m_loader, SIGNAL(finished()), this, SLOT(importFinished()));
+
+	m_loader->start();
+}
 
-	QFile file(SettingsManager::getPath() + QLatin1String("/bookmarks.xbel"));
+void BookmarksManager::importFinished()
+{
+	BookmarksImporter *importer = qobject_cast<BookmarksImporter*>(sender());
 
-	if (!file.open(QFile::ReadOnly | QFile::Text))
+	if (!importer)
 	{
 		return;
 	}
 
-	QXmlStreamReader reader(file.readAll());
+	const QList<BookmarkInformation*> bookmarks = importer->takeBookmarks();
+	int folder = importer->getFolder();
 
-	if (reader.readNextStartElement() && reader.name() == QLatin1String("xbel") && reader.attributes().value(QLatin1String("version")).toString() == QLatin1String("1.0"))
+	if (!getChildren(folder))
 	{
-		while (reader.readNextStartElement())
-		{
-			if (reader.name() == QLatin1String("folder") || reader.name() == QLatin1String("bookmark") || reader.name() == QLatin1String("separator"))
-			{
-				m_bookmarks.append(readBookmark(&reader, 0));
-			}
-			else
-			{
-				reader.skipCurrentElement();
-			}
-		}
+		folder = 0;
+	}
+
+	QList<BookmarkInformation*> *children = getChildren(folder);
+	const int offset = ((importer == m_loader) ? 0 : children->count());
+
+	for (int i = 0; i < bookmarks.count(); ++i)
+	{
+		registerBookmark(bookmarks.at(i), folder);
 	}
 
-	updateUrls();
+	if (importer == m_loader)
+	{
+		m_loader = NULL;
 
-	emit folderModified(0);
+		*children = (bookmarks + *children);
+	}
+	else
+	{
+		children->append(bookmarks);
+
+		scheduleSave();
+	}
+
+	importer->deleteLater();
+
+	for (int i = 0; i < bookmarks.count(); ++i)
+	{
+		emit bookmarkAdded(bookmarks.at(i), folder, (offset + i));
+	}
+
+	emit folderModified(folder);
 }
 
-void BookmarksManager::writeBookmark(QXmlStreamWriter *writer, BookmarkInformation *bookmark)
+void BookmarksManager::saveFinished()
 {
-	switch (bookmark->type)
+	BookmarksWriter *writer = qobject_cast<BookmarksWriter*>(sender());
+
+	if (writer == m_writer)
 	{
-		case FolderBookmark:
-			writer->writeStartElement(QLatin1String("folder"));
-			writer->writeTextElement(QLatin1String("title"), bookmark->title);
+		m_writer = NULL;
+	}
 
-			for (int i = 0; i < bookmark->children.count(); ++i)
-			{
-				writeBookmark(writer, bookmark->children.at(i));
-			}
+	if (writer)
+	{
+		writer->deleteLater();
+	}
+}
 
-			writer->writeEndElement();
+void BookmarksManager::registerBookmark(BookmarkInformation *bookmark, int parent)
+{
+	bookmark->identifier = ++m_identifier;
+	bookmark->parent = parent;
 
-			break;
-		case UrlBookmark:
-			writer->writeStartElement(QLatin1String("bookmark"));
+	m_pointers[bookmark->identifier] = bookmark;
 
-			if (!bookmark->url.isEmpty())
-			{
-				writer->writeAttribute(QLatin1String("href"), bookmark->url);
-			}
+	indexUrl(bookmark);
 
-			writer->writeTextElement(QLatin1String("title"), bookmark->title);
+	for (int i = 0; i < bookmark->children.count(); ++i)
+	{
+		registerBookmark(bookmark->children.at(i), bookmark->identifier);
+	}
+}
 
-			if (!bookmark->description.isEmpty())
-			{
-				writer->writeTextElement(QLatin1String("desc"), bookmark->description);
-			}
+void BookmarksManager::unregisterBookmark(BookmarkInformation *bookmark)
+{
+	for (int i = 0; i < bookmark->children.count(); ++i)
+	{
+		unregisterBookmark(bookmark->children.at(i));
+	}
 
-			writer->writeEndElement();
+	unindexUrl(bookmark);
 
-			break;
-		default:
-			writer->writeEmptyElement(QLatin1String("separator"));
+	m_pointers.remove(bookmark->identifier);
+}
 
-			break;
+void BookmarksManager::destroyBookmark(BookmarkInformation *bookmark)
+{
+	for (int i = 0; i < bookmark->children.count(); ++i)
+	{
+		destroyBookmark(bookmark->children.at(i));
 	}
+
+	delete bookmark;
 }
 
-void BookmarksManager::updateUrls()
+void BookmarksManager::indexUrl(BookmarkInformation *bookmark)
 {
-	QStringList urls;
+	if (bookmark->type != UrlBookmark)
+	{
+		return;
+	}
 
-	for (int i = 0; i < m_allBookmarks.count(); ++i)
+	const QString url = Utils::getNormalizedUrl(QUrl(bookmark->url));
+
+	if (url.isEmpty())
 	{
-		if (m_allBookmarks.at(i) && m_allBookmarks.at(i)->type == UrlBookmark)
-		{
-			const QUrl url(m_allBookmarks.at(i)->url);
+		return;
+	}
 
-			if (url.isValid())
-			{
-				urls.append(url.toString(QUrl::RemovePassword | QUrl::RemoveFragment));
-			}
-		}
+	const quint64 fingerprint = Utils::getFingerprint(url);
+	const bool isNew = !m_urls.contains(fingerprint);
+
+	m_indexedUrls[bookmark->identifier] = url;
+	m_urls.insert(fingerprint, bookmark);
+
+	if (isNew)
+	{
+		emit m_instance->urlAdded(url);
 	}
+}
 
-	m_urls = urls.toSet();
+void BookmarksManager::unindexUrl(BookmarkInformation *bookmark)
+{
+	if (!m_indexedUrls.contains(bookmark->identifier))
+	{
+		return;
+	}
+
+	const QString url = m_indexedUrls.take(bookmark->identifier);
+	const quint64 fingerprint = Utils::getFingerprint(url);
+
+	m_urls.remove(fingerprint, bookmark);
+
+	if (!m_urls.contains(fingerprint))
+	{
+		emit m_instance->urlRemoved(url);
+	}
 }
 
 void BookmarksManager::createInstance(QObject *parent)
@@ -148,93 +265,36 @@ void BookmarksManager::createInstance(QObject *parent)
 	m_instance = new BookmarksManager(parent);
 }
 
+void BookmarksManager::importBookmarks(const QString &path, int folder)
+{
+	BookmarksImporter *importer = new BookmarksImporter(path, folder, m_instance);
+
+	connect(importer, SIGNAL(finished()), m_instance, SLOT(importFinished()));
+
+	importer->start();
+}
+
 BookmarksManager *BookmarksManager::getInstance()
 {
 	return m_instance;
 }
 
-QStringList BookmarksManager::getUrls()
+BookmarkInformation* BookmarksManager::getBookmark(int identifier)
 {
-	return m_urls.toList();
+	return m_pointers.value(identifier, NULL);
 }
 
-BookmarkInformation *BookmarksManager::readBookmark(QXmlStreamReader *reader, int parent)
+QStringList BookmarksManager::getUrls()
 {
-	BookmarkInformation *bookmark = new BookmarkInformation();
-	bookmark->parent = parent;
-
-	if (reader->name() == QLatin1String("folder"))
-	{
-		bookmark->type = FolderBookmark;
-		bookmark->identifier = ++m_identifier;
-
-		while (reader->readNext())
-		{
-			if (reader->isStartElement())
-			{
-				if (reader->name() == QLatin1String("title"))
-				{
-					bookmark->title = reader->readElementText().trimmed();
-				}
-				else if (reader->name() == QLatin1String("desc"))
-				{
-					bookmark->description = reader->readElementText().trimmed();
-				}
-				else if (reader->name() == QLatin1String("folder") || reader->name() == QLatin1String("bookmark") || reader->name() == QLatin1String("separator"))
-				{
-					bookmark->children.append(readBookmark(reader, bookmark->identifier));
-				}
-				else
-				{
-					reader->skipCurrentElement();
-				}
-			}
-			else if (reader->isEndElement() && reader->name() == QLatin1String("folder"))
-			{
-				break;
-			}
-		}
-
-		m_pointers[bookmark->identifier] = bookmark;
-	}
-	else if (reader->name() == QLatin1String("bookmark"))
-	{
-		bookmark->type = UrlBookmark;
-		bookmark->url = reader->attributes().value(QLatin1String("href")).toString();
+	const QList<quint64> fingerprints = m_urls.uniqueKeys();
+	QStringList urls;
 
-		while (reader->readNext())
-		{
-			if (reader->isStartElement())
-			{
-				if (reader->name() == QLatin1String("title"))
-				{
-					bookmark->title = reader->readElementText().trimmed();
-				}
-				else if (reader->name() == QLatin1String("desc"))
-				{
-					bookmark->description = reader->readElementText().trimmed();
-				}
-				else
-				{
-					reader->skipCurrentElement();
-				}
-			}
-			else if (reader->isEndElement() && reader->name() == QLatin1String("bookmark"))
-			{
-				break;
-			}
-		}
-	}
-	else if (reader->name() == QLatin1String("separator"))
+	for (int i = 0; i < fingerprints.count(); ++i)
 	{
-		bookmark->type = SeparatorBookmark;
-
-		reader->readNext();
+		urls.append(m_indexedUrls.value(m_urls.value(fingerprints.at(i))->identifier));
 	}
 
-	m_allBookmarks.append(bookmark);
-
-	return bookmark;
+	return urls;
 }
 
 QList<BookmarkInformation*> BookmarksManager::getBookmarks()
@@ -242,66 +302,119 @@ QList<BookmarkInformation*> BookmarksManager::getBookmarks()
 	return m_bookmarks;
 }
 
+QList<BookmarkInformation*> BookmarksManager::getBookmarks(const QUrl &url)
+{
+	return m_urls.values(Utils::getUrlFingerprint(url));
+}
+
 QList<BookmarkInformation*> BookmarksManager::getFolder(int folder)
+{
+	QList<BookmarkInformation*> *children = getChildren(folder);
+
+	return (children ? *children : QList<BookmarkInformation*>());
+}
+
+QList<BookmarkInformation*>* BookmarksManager::getChildren(int folder)
 {
 	if (folder == 0)
 	{
-		return m_bookmarks;
+		return &m_bookmarks;
 	}
 
-	if (m_pointers.contains(folder))
+	BookmarkInformation *bookmark = m_pointers.value(folder, NULL);
+
+	if (bookmark && bookmark->type == FolderBookmark)
 	{
-		return m_pointers[folder]->children;
+		return &bookmark->children;
 	}
 
-	return QList<BookmarkInformation*>();
+	return NULL;
 }
 
 bool BookmarksManager::addBookmark(BookmarkInformation *bookmark, int folder, int index)
 {
-	if (!bookmark || (folder != 0 && !m_pointers.contains(folder)))
+	QList<BookmarkInformation*> *children = getChildren(folder);
+
+	if (!bookmark || !children)
 	{
 		return false;
 	}
 
-	const QUrl url(bookmark->url);
+	registerBookmark(bookmark, folder);
+
+	const int row = ((index < 0 || index > children->count()) ? children->count() : index);
+
+	children->insert(row, bookmark);
+
+	m_instance->scheduleSave();
+
+	emit m_instance->bookmarkAdded(bookmark, folder, row);
+	emit m_instance->folderModified(folder);
+
+	return true;
+}
+
+bool BookmarksManager::moveBookmark(BookmarkInformation *bookmark, int folder, int index)
+{
+	QList<BookmarkInformation*> *children = getChildren(folder);
 
-	if (url.isValid())
+	if (!bookmark || !children || m_pointers.value(bookmark->identifier) != bookmark)
 	{
-		m_urls.insert(url.toString(QUrl::RemovePassword | QUrl::RemoveFragment));
+		return false;
 	}
 
-	if (bookmark->type == FolderBookmark)
+	for (BookmarkInformation *parent = m_pointers.value(folder, NULL); parent; parent = m_pointers.value(parent->parent, NULL))
 	{
-		bookmark->identifier = ++m_identifier;
-
-		m_pointers[bookmark->identifier] = bookmark;
+		if (parent == bookmark)
+		{
+			return false;
+		}
 	}
 
-	bookmark->parent = folder;
+	const int previousFolder = bookmark->parent;
+	QList<BookmarkInformation*> *previousChildren = getChildren(previousFolder);
+	const int previousIndex = (previousChildren ? previousChildren->indexOf(bookmark) : -1);
 
-	if (folder == 0)
+	if (previousIndex >= 0)
 	{
-		m_bookmarks.insert(((index < 0) ? m_bookmarks.count() : index), bookmark);
+		previousChildren->removeAt(previousIndex);
 	}
-	else
+
+	if (previousFolder == folder && index > previousIndex && previousIndex >= 0)
 	{
-		m_pointers[folder]->children.insert(((index < 0) ? m_pointers[folder]->children.count() : index), bookmark);
+		--index;
 	}
 
-	m_allBookmarks.append(bookmark);
+	bookmark->parent = folder;
+
+	const int row = ((index < 0 || index > children->count()) ? children->count() : index);
+
+	children->insert(row, bookmark);
+
+	m_instance->scheduleSave();
+
+	emit m_instance->bookmarkMoved(bookmark, previousFolder, previousIndex, folder, row);
+
+	if (previousFolder != folder)
+	{
+		emit m_instance->folderModified(previousFolder);
+	}
 
 	emit m_instance->folderModified(folder);
 
-	return save();
+	return true;
 }
 
 bool BookmarksManager::updateBookmark(BookmarkInformation *bookmark)
 {
-	if (bookmark && m_allBookmarks.contains(bookmark))
+	if (bookmark && m_pointers.value(bookmark->identifier) == bookmark)
 	{
-		updateUrls();
+		unindexUrl(bookmark);
+		indexUrl(bookmark);
+
+		m_instance->scheduleSave();
 
+		emit m_instance->bookmarkChanged(bookmark, bookmark->parent, getFolder(bookmark->parent).indexOf(bookmark));
 		emit m_instance->folderModified(bookmark->parent);
 
 		return true;
@@ -312,37 +425,32 @@ bool BookmarksManager::updateBookmark(BookmarkInformation *bookmark)
 
 bool BookmarksManager::deleteBookmark(BookmarkInformation *bookmark, bool notify)
 {
-	if (!bookmark || !m_allBookmarks.contains(bookmark))
+	if (!bookmark || m_pointers.value(bookmark->identifier) != bookmark)
 	{
 		return false;
 	}
 
 	const int folder = bookmark->parent;
+	QList<BookmarkInformation*> *children = getChildren(folder);
+	const int row = (children ? children->indexOf(bookmark) : -1);
 
-	for (int i = 0; i < bookmark->children.count(); ++i)
-	{
-		deleteBookmark(bookmark->children.at(i), false);
-	}
-
-	m_bookmarks.removeAll(bookmark);
-	m_allBookmarks.removeAll(bookmark);
-	m_pointers[folder]->children.removeAll(bookmark);
-
-	if (bookmark->type == FolderBookmark)
+	if (row >= 0)
 	{
-		m_pointers.remove(bookmark->identifier);
+		children->removeAt(row);
 	}
 
-	delete bookmark;
+	unregisterBookmark(bookmark);
 
 	if (notify)
 	{
-		save();
-		updateUrls();
+		m_instance->scheduleSave();
 
+		emit m_instance->bookmarkRemoved(bookmark, folder, row);
 		emit m_instance->folderModified(folder);
 	}
 
+	destroyBookmark(bookmark);
+
 	return true;
 }
 
@@ -354,12 +462,13 @@ bool BookmarksManager::deleteBookmark(const QUrl &url)
 	}
 
 	const QString bookmarkUrl = url.toString(QUrl::RemovePassword);
+	const QList<BookmarkInformation*> bookmarks = getBookmarks(url);
 
-	for (int i = 0; i < m_allBookmarks.count(); ++i)
+	for (int i = 0; i < bookmarks.count(); ++i)
 	{
-		if (m_allBookmarks.at(i) && m_allBookmarks.at(i)->type == UrlBookmark && m_allBookmarks.at(i)->url == bookmarkUrl)
+		if (bookmarks.at(i)->url == bookmarkUrl)
 		{
-			deleteBookmark(m_allBookmarks.at(i));
+			deleteBookmark(bookmarks.at(i));
 		}
 	}
 
@@ -383,34 +492,21 @@ bool BookmarksManager::hasBookmark(const QUrl &url)
 		return false;
 	}
 
-	return m_urls.contains(url.toString(QUrl::RemovePassword | QUrl::RemoveFragment));
+	return m_urls.contains(Utils::getUrlFingerprint(url));
 }
 
-bool BookmarksManager::save(const QString &path)
+bool BookmarksManager::hasBookmark(quint64 fingerprint)
 {
-	QFile file(path.isEmpty() ? SettingsManager::getPath() + QLatin1String("/bookmarks.xbel") : path);
-
-	if (!file.open(QFile::WriteOnly))
-	{
-		return false;
-	}
-
-	QXmlStreamWriter writer(&file);
-	writer.setAutoFormatting(true);
-	writer.setAutoFormattingIndent(-1);
-	writer.writeStartDocument();
-	writer.writeDTD(QLatin1String("<!DOCTYPE xbel>"));
-	writer.writeStartElement(QLatin1String("xbel"));
-	writer.writeAttribute(QLatin1String("version"), QLatin1String("1.0"));
+	return (fingerprint != 0 && m_urls.contains(fingerprint));
+}
 
-	for (int i = 0; i < m_bookmarks.count(); ++i)
-	{
-		writeBookmark(&writer, m_bookmarks.at(i));
-	}
+void BookmarksManager::save()
+{
+	m_writer = new BookmarksWriter((SettingsManager::getPath() + QLatin1String("/bookmarks.xbel")), m_bookmarks, this);
 
-	writer.writeEndDocument();
+	connect(m_writer, SIGNAL(finished()), this, SLOT(saveFinished()));
 
-	return true;
+	m_writer->start();
 }
 
 }
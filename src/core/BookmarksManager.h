@@ -20,6 +20,7 @@
 #ifndef OTTER_BOOKMARKSMANAGER_H
 #define OTTER_BOOKMARKSMANAGER_H
 
+#include <QtCore/QMultiHash>
 #include <QtCore/QObject>
 #include <QtCore/QXmlStreamReader>
 #include <QtCore/QXmlStreamWriter>
@@ -47,6 +48,9 @@ struct BookmarkInformation
 	BookmarkInformation() : type(FolderBookmark), identifier(-1), parent(-1) {}
 };
 
+class BookmarksImporter;
+class BookmarksWriter;
+
 class BookmarksManager : public QObject
 {
 	Q_OBJECT
@@ -55,37 +59,61 @@ public:
 	~BookmarksManager();
 
 	static void createInstance(QObject *parent = NULL);
+	static void importBookmarks(const QString &path, int folder = 0);
 	static BookmarksManager* getInstance();
+	static BookmarkInformation* getBookmark(int identifier);
 	static QStringList getUrls();
 	static QList<BookmarkInformation*> getBookmarks();
+	static QList<BookmarkInformation*> getBookmarks(const QUrl &url);
 	static QList<BookmarkInformation*> getFolder(int folder = 0);
 	static bool addBookmark(BookmarkInformation *bookmark, int folder = 0, int index = -1);
+	static bool moveBookmark(BookmarkInformation *bookmark, int folder, int index = -1);
 	static bool updateBookmark(BookmarkInformation *bookmark);
 	static bool deleteBookmark(BookmarkInformation *bookmark, bool notify = true);
 	static bool deleteBookmark(const QUrl &url);
 	static bool hasBookmark(const QString &url);
 	static bool hasBookmark(const QUrl &url);
-	static bool save(const QString &path = QString());
+	static bool hasBookmark(quint64 fingerprint);
+
+protected:
+	void timerEvent(QTimerEvent *event);
+	void scheduleSave();
+	void save();
 
 private:
 	explicit BookmarksManager(QObject *parent = NULL);
 
-	static void writeBookmark(QXmlStreamWriter *writer, BookmarkInformation *bookmark);
-	static void updateUrls();
-	BookmarkInformation* readBookmark(QXmlStreamReader *reader, int parent = -1);
+	static void registerBookmark(BookmarkInformation *bookmark, int parent);
+	static void unregisterBookmark(BookmarkInformation *bookmark);
+	static void destroyBookmark(BookmarkInformation *bookmark);
+	static void indexUrl(BookmarkInformation *bookmark);
+	static void unindexUrl(BookmarkInformation *bookmark);
+	static QList<BookmarkInformation*>* getChildren(int folder);
+
+	BookmarksImporter *m_loader;
+	BookmarksWriter *m_writer;
+	int m_saveTimer;
 
 	static BookmarksManager *m_instance;
 	static QHash<int, BookmarkInformation*> m_pointers;
+	static QHash<int, QString> m_indexedUrls;
 	static QList<BookmarkInformation*> m_bookmarks;
-	static QList<BookmarkInformation*> m_allBookmarks;
-	static QSet<QString> m_urls;
+	static QMultiHash<quint64, BookmarkInformation*> m_urls;
 	static int m_identifier;
 
 private slots:
 	void load();
+	void importFinished();
+	void saveFinished();
 
 signals:
 	void folderModified(int folder);
+	void bookmarkAdded(BookmarkInformation *bookmark, int folder, int row);
+	void bookmarkRemoved(BookmarkInformation *bookmark, int folder, int row);
+	void bookmarkMoved(BookmarkInformation *bookmark, int previousFolder, int previousRow, int folder, int row);
+	void bookmarkChanged(BookmarkInformation *bookmark, int folder, int row);
+	void urlAdded(const QString &url);
+	void urlRemoved(const QString &url);
 };
 
 }
@@ -0,0 +1,137 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2013 - 2014 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "BookmarksWriter.h"
+
+#include <QtCore/QSaveFile>
+
+namespace Otter
+{
+
+BookmarksWriter::BookmarksWriter(const QString &path, const QList<BookmarkInformation*> &bookmarks, QObject *parent) : QThread(parent),
+	m_path(path),
+	m_bookmarks(copyBookmarks(bookmarks))
+{
+}
+
+BookmarksWriter::~BookmarksWriter()
+{
+	wait();
+
+	deleteBookmarks(m_bookmarks);
+}
+
+void BookmarksWriter::run()
+{
+	QSaveFile file(m_path);
+
+	if (!file.open(QFile::WriteOnly))
+	{
+		return;
+	}
+
+	QXmlStreamWriter writer(&file);
+	writer.setAutoFormatting(true);
+	writer.setAutoFormattingIndent(-1);
+	writer.writeStartDocument();
+	writer.writeDTD(QLatin1String("<!DOCTYPE xbel>"));
+	writer.writeStartElement(QLatin1String("xbel"));
+	writer.writeAttribute(QLatin1String("version"), QLatin1String("1.0"));
+
+	for (int i = 0; i < m_bookmarks.count(); ++i)
+	{
+		writeBookmark(&writer, m_bookmarks.at(i));
+	}
+
+	writer.writeEndDocument();
+
+	file.commit();
+}
+
+void BookmarksWriter::writeBookmark(QXmlStreamWriter *writer, BookmarkInformation *bookmark)
+{
+	switch (bookmark->type)
+	{
+		case FolderBookmark:
+			writer->writeStartElement(QLatin1String("folder"));
+			writer->writeTextElement(QLatin1String("title"), bookmark->title);
+
+			for (int i = 0; i < bookmark->children.count(); ++i)
+			{
+				writeBookmark(writer, bookmark->children.at(i));
+			}
+
+			writer->writeEndElement();
+
+			break;
+		case UrlBookmark:
+			writer->writeStartElement(QLatin1String("bookmark"));
+
+			if (!bookmark->url.isEmpty())
+			{
+				writer->writeAttribute(QLatin1String("href"), bookmark->url);
+			}
+
+			writer->writeTextElement(QLatin1String("title"), bookmark->title);
+
+			if (!bookmark->description.isEmpty())
+			{
+				writer->writeTextElement(QLatin1String("desc"), bookmark->description);
+			}
+
+			writer->writeEndElement();
+
+			break;
+		default:
+			writer->writeEmptyElement(QLatin1String("separator"));
+
+			break;
+	}
+}
+
+void BookmarksWriter::deleteBookmarks(const QList<BookmarkInformation*> &bookmarks)
+{
+	for (int i = 0; i < bookmarks.count(); ++i)
+	{
+		deleteBookmarks(bookmarks.at(i)->children);
+
+		delete bookmarks.at(i);
+	}
+}
+
+QList<BookmarkInformation*> BookmarksWriter::copyBookmarks(const QList<BookmarkInformation*> &bookmarks)
+{
+	QList<BookmarkInformation*> copies;
+
+	for (int i = 0; i < bookmarks.count(); ++i)
+	{
+		BookmarkInformation *copy = new BookmarkInformation();
+		copy->url = bookmarks.at(i)->url;
+		copy->title = bookmarks.at(i)->title;
+		copy->description = bookmarks.at(i)->description;
+		copy->type = bookmarks.at(i)->type;
+		copy->children = copyBookmarks(bookmarks.at(i)->children);
+
+		copies.append(copy);
+	}
+
+	return copies;
+}
+
+}
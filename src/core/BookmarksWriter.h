@@ -0,0 +1,51 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2013 - 2014 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_BOOKMARKSWRITER_H
+#define OTTER_BOOKMARKSWRITER_H
+
+#include "BookmarksManager.h"
+
+#include <QtCore/QThread>
+
+namespace Otter
+{
+
+class BookmarksWriter : public QThread
+{
+	Q_OBJECT
+
+public:
+	explicit BookmarksWriter(const QString &path, const QList<BookmarkInformation*> &bookmarks, QObject *parent = NULL);
+	~BookmarksWriter();
+
+protected:
+	void run();
+	static void writeBookmark(QXmlStreamWriter *writer, BookmarkInformation *bookmark);
+	static void deleteBookmarks(const QList<BookmarkInformation*> &bookmarks);
+	static QList<BookmarkInformation*> copyBookmarks(const QList<BookmarkInformation*> &bookmarks);
+
+private:
+	QString m_path;
+	QList<BookmarkInformation*> m_bookmarks;
+};
+
+}
+
+#endif
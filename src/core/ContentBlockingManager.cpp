@@ -0,0 +1,802 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2013 - 2014 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "ContentBlockingManager.h"
+#include "SettingsManager.h"
+
+#include <QtCore/QDataStream>
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QSaveFile>
+#include <QtCore/QTextStream>
+#include <QtCore/QTimerEvent>
+
+namespace Otter
+{
+
+ContentBlockingManager* ContentBlockingManager::m_instance = NULL;
+QVector<ContentBlockingRule> ContentBlockingManager::m_rules;
+QMultiHash<QString, int> ContentBlockingManager::m_domainIndex;
+QMultiHash<QString, int> ContentBlockingManager::m_tokenIndex;
+QVector<int> ContentBlockingManager::m_genericIndex;
+QStringList ContentBlockingManager::m_selectors;
+QString ContentBlockingManager::m_styleSheet;
+int ContentBlockingManager::m_blockedRequests = 0;
+int ContentBlockingManager::m_checkedRequests = 0;
+bool ContentBlockingManager::m_enabled = false;
+
+ContentBlockingManager::ContentBlockingManager(QObject *parent) : QObject(parent),
+	m_watcher(NULL),
+	m_reloadTimer(0)
+{
+	m_enabled = SettingsManager::getValue(QLatin1String("Content/EnableContentBlocking")).toBool();
+
+	if (m_enabled)
+	{
+		loadRules();
+	}
+
+	QDir().mkpath(getListsPath());
+
+	m_watcher = new QFileSystemWatcher(QStringList(getListsPath()), this);
+
+	connect(m_watcher, SIGNAL(directoryChanged(QString)), this, SLOT(scheduleReload()));
+
+	connect(SettingsManager::getInstance(), SIGNAL(valueChanged(QString,QVariant)), this, SLOT(optionChanged(QString,QVariant)));
+}
+
+void ContentBlockingManager::createInstance(QObject *parent)
+{
+	m_instance = new ContentBlockingManager(parent);
+}
+
+void ContentBlockingManager::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() == m_reloadTimer)
+	{
+		killTimer(m_reloadTimer);
+
+		m_reloadTimer = 0;
+
+		if (m_enabled)
+		{
+			loadRules();
+
+			emit rulesChanged();
+		}
+	}
+}
+
+void ContentBlockingManager::optionChanged(const QString &option, const QVariant &value)
+{
+	if (option == QLatin1String("Content/EnableContentBlocking") && value.toBool() != m_enabled)
+	{
+		m_enabled = value.toBool();
+
+		if (m_enabled && m_rules.isEmpty())
+		{
+			loadRules();
+		}
+
+		emit rulesChanged();
+	}
+}
+
+void ContentBlockingManager::scheduleReload()
+{
+	if (m_reloadTimer == 0)
+	{
+		m_reloadTimer = startTimer(1000);
+	}
+}
+
+void ContentBlockingManager::loadRules()
+{
+	m_rules.clear();
+	m_selectors.clear();
+	m_styleSheet.clear();
+
+	const QStringList state = getListsState();
+
+	if (state.isEmpty())
+	{
+		buildIndex();
+
+		return;
+	}
+
+	if (!readCache(state))
+	{
+		m_rules.clear();
+		m_selectors.clear();
+
+		const QStringList lists = QDir(getListsPath()).entryList(QStringList(QLatin1String("*.txt")), QDir::Files, QDir::Name);
+
+		for (int i = 0; i < lists.count(); ++i)
+		{
+			parseList(QDir(getListsPath()).filePath(lists.at(i)));
+		}
+
+		m_selectors.removeDuplicates();
+
+		writeCache(state);
+	}
+
+	buildIndex();
+
+	for (int i = 0; i < m_selectors.count(); i += 20)
+	{
+		m_styleSheet.append(QStringList(m_selectors.mid(i, 20)).join(QLatin1String(", ")));
+		m_styleSheet.append(QLatin1String(" {display: none !important;}\n"));
+	}
+}
+
+void ContentBlockingManager::parseList(const QString &path)
+{
+	QFile file(path);
+
+	if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+	{
+		return;
+	}
+
+	QTextStream stream(&file);
+	stream.setCodec("UTF-8");
+
+	while (!stream.atEnd())
+	{
+		parseRule(stream.readLine().trimmed());
+	}
+}
+
+void ContentBlockingManager::parseRule(const QString &line)
+{
+	if (line.isEmpty() || line.startsWith(QLatin1Char('!')) || line.startsWith(QLatin1Char('[')))
+	{
+		return;
+	}
+
+	const int hidingPosition = line.indexOf(QLatin1String("##"));
+
+	if (hidingPosition >= 0)
+	{
+		if (hidingPosition == 0 && line.length() > 2 && !line.contains(QLatin1String(":-abp-")) && !line.contains(QLatin1String(":has(")) && !line.contains(QLatin1String(":has-text(")) && !line.contains(QLatin1String(":xpath(")))
+		{
+			m_selectors.append(line.mid(2));
+		}
+
+		return;
+	}
+
+	if (line.contains(QLatin1String("#@#")) || line.contains(QLatin1String("#?#")) || line.contains(QLatin1String("#$#")))
+	{
+		return;
+	}
+
+	ContentBlockingRule rule;
+	QString pattern = line;
+
+	if (pattern.startsWith(QLatin1String("@@")))
+	{
+		rule.options |= ExceptionRuleOption;
+
+		pattern = pattern.mid(2);
+	}
+
+	if (pattern.startsWith(QLatin1Char('/')) && pattern.endsWith(QLatin1Char('/')) && pattern.length() > 1)
+	{
+		return;
+	}
+
+	const int optionsPosition = pattern.lastIndexOf(QLatin1Char('$'));
+
+	if (optionsPosition >= 0)
+	{
+		const QStringList options = pattern.mid(optionsPosition + 1).split(QLatin1Char(','), QString::SkipEmptyParts);
+		int types = 0;
+		int excludedTypes = 0;
+
+		pattern = pattern.left(optionsPosition);
+
+		for (int i = 0; i < options.count(); ++i)
+		{
+			QString option = options.at(i).toLower();
+			const bool isInverted = option.startsWith(QLatin1Char('~'));
+
+			if (isInverted)
+			{
+				option = option.mid(1);
+			}
+
+			int type = -1;
+
+			if (option == QLatin1String("script"))
+			{
+				type = NetworkAccessManager::ScriptRequest;
+			}
+			else if (option == QLatin1String("image"))
+			{
+				type = NetworkAccessManager::ImageRequest;
+			}
+			else if (option == QLatin1String("stylesheet"))
+			{
+				type = NetworkAccessManager::StyleSheetRequest;
+			}
+			else if (option == QLatin1String("subdocument"))
+			{
+				type = NetworkAccessManager::DocumentRequest;
+			}
+			else if (option == QLatin1String("object") || option == QLatin1String("xmlhttprequest") || option == QLatin1String("media") || option == QLatin1String("font") || option == QLatin1String("other"))
+			{
+				type = NetworkAccessManager::OtherRequest;
+			}
+
+			if (type >= 0)
+			{
+				if (isInverted)
+				{
+					excludedTypes |= (1 << type);
+				}
+				else
+				{
+					types |= (1 << type);
+				}
+			}
+			else if (option == QLatin1String("third-party"))
+			{
+				rule.options |= (isInverted ? FirstPartyRuleOption : ThirdPartyRuleOption);
+			}
+			else if (option.startsWith(QLatin1String("domain=")))
+			{
+				const QStringList domains = option.mid(7).split(QLatin1Char('|'), QString::SkipEmptyParts);
+
+				for (int j = 0; j < domains.count(); ++j)
+				{
+					if (domains.at(j).startsWith(QLatin1Char('~')))
+					{
+						rule.blockedDomains.append(domains.at(j).mid(1));
+					}
+					else
+					{
+						rule.allowedDomains.append(domains.at(j));
+					}
+				}
+			}
+			else if (option == QLatin1String("match-case"))
+			{
+				rule.options |= MatchCaseRuleOption;
+			}
+			else
+			{
+				return;
+			}
+		}
+
+		if (excludedTypes != 0)
+		{
+			types = ((types == 0) ? ((1 << (NetworkAccessManager::ImageRequest + 1)) - 1) : types) & ~excludedTypes;
+
+			if (types == 0)
+			{
+				return;
+			}
+		}
+
+		rule.types = types;
+	}
+
+	if (!(rule.options & MatchCaseRuleOption))
+	{
+		pattern = pattern.toLower();
+	}
+
+	if (pattern.startsWith(QLatin1String("||")))
+	{
+		rule.options |= DomainAnchorRuleOption;
+
+		pattern = pattern.mid(2);
+	}
+	else if (pattern.startsWith(QLatin1Char('|')))
+	{
+		rule.options |= StartAnchorRuleOption;
+
+		pattern = pattern.mid(1);
+	}
+
+	if (pattern.endsWith(QLatin1Char('|')))
+	{
+		rule.options |= EndAnchorRuleOption;
+
+		pattern.chop(1);
+	}
+
+	while (pattern.startsWith(QLatin1Char('*')) && !(rule.options & (DomainAnchorRuleOption | StartAnchorRuleOption)))
+	{
+		pattern = pattern.mid(1);
+	}
+
+	if (pattern.isEmpty() && rule.allowedDomains.isEmpty())
+	{
+		return;
+	}
+
+	rule.pattern = pattern;
+
+	m_rules.append(rule);
+}
+
+void ContentBlockingManager::buildIndex()
+{
+	m_domainIndex.clear();
+	m_tokenIndex.clear();
+	m_genericIndex.clear();
+
+	for (int i = 0; i < m_rules.count(); ++i)
+	{
+		const ContentBlockingRule &rule = m_rules.at(i);
+
+		if (rule.options & DomainAnchorRuleOption)
+		{
+			int length = 0;
+
+			while (length < rule.pattern.length() && (rule.pattern.at(length).isLetterOrNumber() || rule.pattern.at(length) == QLatin1Char('.') || rule.pattern.at(length) == QLatin1Char('-')))
+			{
+				++length;
+			}
+
+			const bool hasCompleteHost = (length > 0 && rule.pattern.at(length - 1) != QLatin1Char('.') && ((length == rule.pattern.length()) ? (rule.options & EndAnchorRuleOption) : (rule.pattern.at(length) == QLatin1Char('^') || rule.pattern.at(length) == QLatin1Char('/') || rule.pattern.at(length) == QLatin1Char(':'))));
+
+			if (hasCompleteHost)
+			{
+				m_domainIndex.insert(rule.pattern.left(length).toLower(), i);
+
+				continue;
+			}
+		}
+
+		const QString token = getToken(rule);
+
+		if (token.isEmpty())
+		{
+			m_genericIndex.append(i);
+		}
+		else
+		{
+			m_tokenIndex.insert(token, i);
+		}
+	}
+}
+
+QString ContentBlockingManager::getToken(const ContentBlockingRule &rule)
+{
+	const QString &pattern = rule.pattern;
+	QString token;
+	int start = -1;
+
+	for (int i = 0; i <= pattern.length(); ++i)
+	{
+		const bool isTokenCharacter = (i < pattern.length() && pattern.at(i).isLetterOrNumber());
+
+		if (isTokenCharacter && start < 0)
+		{
+			start = i;
+		}
+		else if (!isTokenCharacter && start >= 0)
+		{
+			const bool hasStart = (start > 0 ? (pattern.at(start - 1) != QLatin1Char('*')) : (rule.options & (DomainAnchorRuleOption | StartAnchorRuleOption)));
+			const bool hasEnd = ((i < pattern.length()) ? (pattern.at(i) != QLatin1Char('*')) : (rule.options & EndAnchorRuleOption));
+
+			if (hasStart && hasEnd && (i - start) > token.length() && (i - start) >= 3)
+			{
+				token = pattern.mid(start, (i - start)).toLower();
+			}
+
+			start = -1;
+		}
+	}
+
+	return token;
+}
+
+QString ContentBlockingManager::getListsPath()
+{
+	return SettingsManager::getPath() + QLatin1String("/blocking/");
+}
+
+QString ContentBlockingManager::getCachePath()
+{
+	return SettingsManager::getPath() + QLatin1String("/blocking.dat");
+}
+
+QStringList ContentBlockingManager::getListsState()
+{
+	const QFileInfoList lists = QDir(getListsPath()).entryInfoList(QStringList(QLatin1String("*.txt")), QDir::Files, QDir::Name);
+	QStringList state;
+
+	for (int i = 0; i < lists.count(); ++i)
+	{
+		state.append(QString("%1:%2:%3").arg(lists.at(i).fileName()).arg(lists.at(i).size()).arg(lists.at(i).lastModified().toMSecsSinceEpoch()));
+	}
+
+	return state;
+}
+
+bool ContentBlockingManager::readCache(const QStringList &state)
+{
+	QFile file(getCachePath());
+
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		return false;
+	}
+
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_0);
+
+	quint32 magic;
+	quint16 version;
+	QStringList cachedState;
+
+	stream >> magic >> version;
+
+	if (magic != 0x4F43424C || version != 2)
+	{
+		return false;
+	}
+
+	stream >> cachedState;
+
+	if (cachedState != state)
+	{
+		return false;
+	}
+
+	quint32 amount;
+
+	stream >> amount;
+
+	m_rules.reserve(amount);
+
+	for (quint32 i = 0; i < amount; ++i)
+	{
+		ContentBlockingRule rule;
+		qint32 options;
+		qint32 types;
+
+		stream >> rule.pattern >> rule.allowedDomains >> rule.blockedDomains >> options >> types;
+
+		rule.options = options;
+		rule.types = types;
+
+		m_rules.append(rule);
+	}
+
+	stream >> m_selectors;
+
+	return (stream.status() == QDataStream::Ok);
+}
+
+bool ContentBlockingManager::writeCache(const QStringList &state)
+{
+	QSaveFile file(getCachePath());
+
+	if (!file.open(QIODevice::WriteOnly))
+	{
+		return false;
+	}
+
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_0);
+	stream << quint32(0x4F43424C) << quint16(2) << state << quint32(m_rules.count());
+
+	for (int i = 0; i < m_rules.count(); ++i)
+	{
+		stream << m_rules.at(i).pattern << m_rules.at(i).allowedDomains << m_rules.at(i).blockedDomains << qint32(m_rules.at(i).options) << qint32(m_rules.at(i).types);
+	}
+
+	stream << m_selectors;
+
+	return file.commit();
+}
+
+ContentBlockingManager* ContentBlockingManager::getInstance()
+{
+	return m_instance;
+}
+
+QString ContentBlockingManager::getStyleSheet()
+{
+	return (m_enabled ? m_styleSheet : QString());
+}
+
+QVariantHash ContentBlockingManager::getStatistics()
+{
+	QVariantHash statistics;
+	statistics[QLatin1String("rules")] = m_rules.count();
+	statistics[QLatin1String("selectors")] = m_selectors.count();
+	statistics[QLatin1String("checkedRequests")] = m_checkedRequests;
+	statistics[QLatin1String("blockedRequests")] = m_blockedRequests;
+
+	return statistics;
+}
+
+bool ContentBlockingManager::isBlocked(const QUrl &url, const QUrl &firstPartyUrl, NetworkAccessManager::RequestType type)
+{
+	if (!m_enabled || m_rules.isEmpty())
+	{
+		return false;
+	}
+
+	const QString host = url.host(QUrl::FullyEncoded).toLower();
+
+	if (host.isEmpty())
+	{
+		return false;
+	}
+
+	const QString caseSensitiveUrl = url.toString(QUrl::RemoveUserInfo | QUrl::FullyEncoded);
+	const QString urlString = caseSensitiveUrl.toLower();
+	const int hostPosition = urlString.indexOf(host);
+	const QString firstPartyHost = firstPartyUrl.host().toLower();
+
+	++m_checkedRequests;
+
+	if (findRule(urlString, caseSensitiveUrl, hostPosition, host, firstPartyHost, type, false) && !findRule(urlString, caseSensitiveUrl, hostPosition, host, firstPartyHost, type, true))
+	{
+		++m_blockedRequests;
+
+		return true;
+	}
+
+	return false;
+}
+
+bool ContentBlockingManager::findRule(const QString &url, const QString &caseSensitiveUrl, int hostPosition, const QString &host, const QString &firstPartyHost, int type, bool exception)
+{
+	int position = 0;
+
+	while (position >= 0)
+	{
+		const QString domain = host.mid(position);
+		QMultiHash<QString, int>::const_iterator iterator = m_domainIndex.constFind(domain);
+
+		while (iterator != m_domainIndex.constEnd() && iterator.key() == domain)
+		{
+			const ContentBlockingRule &rule = m_rules.at(iterator.value());
+
+			if (((rule.options & ExceptionRuleOption) != 0) == exception && checkRule(rule, url, caseSensitiveUrl, (hostPosition + position), host, firstPartyHost, type))
+			{
+				return true;
+			}
+
+			++iterator;
+		}
+
+		position = host.indexOf(QLatin1Char('.'), position);
+
+		if (position >= 0)
+		{
+			++position;
+		}
+	}
+
+	int start = -1;
+
+	for (int i = 0; i <= url.length(); ++i)
+	{
+		const bool isTokenCharacter = (i < url.length() && url.at(i).isLetterOrNumber());
+
+		if (isTokenCharacter && start < 0)
+		{
+			start = i;
+		}
+		else if (!isTokenCharacter && start >= 0)
+		{
+			if ((i - start) >= 3)
+			{
+				const QString token = url.mid(start, (i - start));
+				QMultiHash<QString, int>::const_iterator iterator = m_tokenIndex.constFind(token);
+
+				while (iterator != m_tokenIndex.constEnd() && iterator.key() == token)
+				{
+					const ContentBlockingRule &rule = m_rules.at(iterator.value());
+
+					if (((rule.options & ExceptionRuleOption) != 0) == exception && checkRule(rule, url, caseSensitiveUrl, -1, host, firstPartyHost, type))
+					{
+						return true;
+					}
+
+					++iterator;
+				}
+			}
+
+			start = -1;
+		}
+	}
+
+	for (int i = 0; i < m_genericIndex.count(); ++i)
+	{
+		const ContentBlockingRule &rule = m_rules.at(m_genericIndex.at(i));
+
+		if (((rule.options & ExceptionRuleOption) != 0) == exception && checkRule(rule, url, caseSensitiveUrl, -1, host, firstPartyHost, type))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool ContentBlockingManager::checkRule(const ContentBlockingRule &rule, const QString &lowerCaseUrl, const QString &caseSensitiveUrl, int hostPosition, const QString &host, const QString &firstPartyHost, int type)
+{
+	if (rule.types != 0 && !(rule.types & (1 << type)))
+	{
+		return false;
+	}
+
+	if (rule.options & (ThirdPartyRuleOption | FirstPartyRuleOption))
+	{
+		const QString baseDomain = host.section(QLatin1Char('.'), -2);
+		const bool isThirdParty = (!firstPartyHost.isEmpty() && firstPartyHost != baseDomain && !firstPartyHost.endsWith(QLatin1Char('.') + baseDomain));
+
+		if (((rule.options & ThirdPartyRuleOption) && !isThirdParty) || ((rule.options & FirstPartyRuleOption) && isThirdParty))
+		{
+			return false;
+		}
+	}
+
+	if ((!rule.allowedDomains.isEmpty() && !matchDomains(firstPartyHost, rule.allowedDomains)) || (!rule.blockedDomains.isEmpty() && matchDomains(firstPartyHost, rule.blockedDomains)))
+	{
+		return false;
+	}
+
+	const QString &url = ((rule.options & MatchCaseRuleOption) ? caseSensitiveUrl : lowerCaseUrl);
+	const bool endAnchor = (rule.options & EndAnchorRuleOption);
+
+	if (rule.options & DomainAnchorRuleOption)
+	{
+		if (hostPosition >= 0)
+		{
+			return matchPattern(rule.pattern, 0, url, hostPosition, endAnchor);
+		}
+
+		const int urlHostPosition = url.indexOf(host);
+		int position = 0;
+
+		while (position >= 0 && urlHostPosition >= 0)
+		{
+			if (matchPattern(rule.pattern, 0, url, (urlHostPosition + position), endAnchor))
+			{
+				return true;
+			}
+
+			position = host.indexOf(QLatin1Char('.'), position);
+
+			if (position >= 0)
+			{
+				++position;
+			}
+		}
+
+		return false;
+	}
+
+	if (rule.options & StartAnchorRuleOption)
+	{
+		return matchPattern(rule.pattern, 0, url, 0, endAnchor);
+	}
+
+	if (rule.pattern.isEmpty())
+	{
+		return true;
+	}
+
+	const QChar first = rule.pattern.at(0);
+	const bool isLiteral = (first != QLatin1Char('*') && first != QLatin1Char('^'));
+
+	for (int i = 0; i < url.length(); ++i)
+	{
+		if (isLiteral)
+		{
+			i = url.indexOf(first, i);
+
+			if (i < 0)
+			{
+				return false;
+			}
+		}
+
+		if (matchPattern(rule.pattern, 0, url, i, endAnchor))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool ContentBlockingManager::matchPattern(const QString &pattern, int patternPosition, const QString &url, int urlPosition, bool endAnchor)
+{
+	while (patternPosition < pattern.length())
+	{
+		const QChar character = pattern.at(patternPosition);
+
+		if (character == QLatin1Char('*'))
+		{
+			++patternPosition;
+
+			if (patternPosition == pattern.length())
+			{
+				return true;
+			}
+
+			for (int i = urlPosition; i <= url.length(); ++i)
+			{
+				if (matchPattern(pattern, patternPosition, url, i, endAnchor))
+				{
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		if (character == QLatin1Char('^'))
+		{
+			if (urlPosition == url.length())
+			{
+				++patternPosition;
+
+				continue;
+			}
+
+			const QChar urlCharacter = url.at(urlPosition);
+
+			if (urlCharacter.isLetterOrNumber() || urlCharacter == QLatin1Char('_') || urlCharacter == QLatin1Char('-') || urlCharacter == QLatin1Char('.') || urlCharacter == QLatin1Char('%'))
+			{
+				return false;
+			}
+		}
+		else if (urlPosition >= url.length() || url.at(urlPosition) != character)
+		{
+			return false;
+		}
+
+		++patternPosition;
+		++urlPosition;
+	}
+
+	return (!endAnchor || urlPosition == url.length());
+}
+
+bool ContentBlockingManager::matchDomains(const QString &host, const QStringList &domains)
+{
+	for (int i = 0; i < domains.count(); ++i)
+	{
+		if (host == domains.at(i) || host.endsWith(QLatin1Char('.') + domains.at(i)))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+}
@@ -0,0 +1,113 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2013 - 2014 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_CONTENTBLOCKINGMANAGER_H
+#define OTTER_CONTENTBLOCKINGMANAGER_H
+
+#include "NetworkAccessManager.h"
+
+#include <QtCore/QFileSystemWatcher>
+#include <QtCore/QMultiHash>
+#include <QtCore/QObject>
+#include <QtCore/QStringList>
+#include <QtCore/QVariant>
+#include <QtCore/QVector>
+
+namespace Otter
+{
+
+enum ContentBlockingRuleOption
+{
+	NoRuleOption = 0,
+	ExceptionRuleOption = 1,
+	DomainAnchorRuleOption = 2,
+	StartAnchorRuleOption = 4,
+	EndAnchorRuleOption = 8,
+	ThirdPartyRuleOption = 16,
+	FirstPartyRuleOption = 32,
+	MatchCaseRuleOption = 64
+};
+
+struct ContentBlockingRule
+{
+	QString pattern;
+	QStringList allowedDomains;
+	QStringList blockedDomains;
+	int options;
+	int types;
+
+	ContentBlockingRule() : options(NoRuleOption), types(0) {}
+};
+
+class ContentBlockingManager : public QObject
+{
+	Q_OBJECT
+
+public:
+	static void createInstance(QObject *parent = NULL);
+	static ContentBlockingManager* getInstance();
+	static QString getStyleSheet();
+	static QVariantHash getStatistics();
+	static bool isBlocked(const QUrl &url, const QUrl &firstPartyUrl, NetworkAccessManager::RequestType type);
+
+protected:
+	void timerEvent(QTimerEvent *event);
+	static void loadRules();
+	static void parseList(const QString &path);
+	static void parseRule(const QString &line);
+	static void buildIndex();
+	static QString getToken(const ContentBlockingRule &rule);
+	static QString getListsPath();
+	static QString getCachePath();
+	static QStringList getListsState();
+	static bool readCache(const QStringList &state);
+	static bool writeCache(const QStringList &state);
+	static bool checkRule(const ContentBlockingRule &rule, const QString &lowerCaseUrl, const QString &caseSensitiveUrl, int hostPosition, const QString &host, const QString &firstPartyHost, int type);
+	static bool findRule(const QString &url, const QString &caseSensitiveUrl, int hostPosition, const QString &host, const QString &firstPartyHost, int type, bool exception);
+	static bool matchPattern(const QString &pattern, int patternPosition, const QString &url, int urlPosition, bool endAnchor);
+	static bool matchDomains(const QString &host, const QStringList &domains);
+
+protected slots:
+	void optionChanged(const QString &option, const QVariant &value);
+	void scheduleReload();
+
+private:
+	explicit ContentBlockingManager(QObject *parent = NULL);
+
+	QFileSystemWatcher *m_watcher;
+	int m_reloadTimer;
+
+	static ContentBlockingManager *m_instance;
+	static QVector<ContentBlockingRule> m_rules;
+	static QMultiHash<QString, int> m_domainIndex;
+	static QMultiHash<QString, int> m_tokenIndex;
+	static QVector<int> m_genericIndex;
+	static QStringList m_selectors;
+	static QString m_styleSheet;
+	static int m_blockedRequests;
+	static int m_checkedRequests;
+	static bool m_enabled;
+
+signals:
+	void rulesChanged();
+};
+
+}
+
+#endif
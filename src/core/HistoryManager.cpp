@@ -19,6 +19,7 @@
 
 #include "HistoryManager.h"
 #include "SettingsManager.h"
+#include "Utils.h"
 
 #include <QtCore/QBuffer>
 #include <QtCore/QFile>
@@ -32,6 +33,7 @@ namespace Otter
 {
 
 HistoryManager* HistoryManager::m_instance = NULL;
+QHash<quint64, qint64> HistoryManager::m_locations;
 bool HistoryManager::m_enabled = false;
 
 HistoryManager::HistoryManager(QObject *parent) : QObject(parent),
@@ -82,6 +84,8 @@ void HistoryManager::timerEvent(QTimerEvent *event)
 		database.exec(QLatin1String("DELETE FROM \"locations\" WHERE \"id\" NOT IN(SELECT DISTINCT \"location\" FROM \"visits\");"));
 		database.exec(QLatin1String("DELETE FROM \"hosts\" WHERE \"id\" NOT IN(SELECT DISTINCT \"host\" FROM \"locations\");"));
 		database.exec(QLatin1String("VACUUM;"));
+
+		m_locations.clear();
 	}
 	else if (event->timerId() == m_dayTimer)
 	{
@@ -166,6 +170,8 @@ void HistoryManager::clearHistory(int period)
 			database.exec(QLatin1String("DELETE FROM \"hosts\";"));
 			database.exec(QLatin1String("DELETE FROM \"icons\";"));
 			database.exec(QLatin1String("VACUUM;"));
+
+			m_locations.clear();
 		}
 	}
 	else if (QFile::exists(path))
@@ -269,6 +275,70 @@ QList<HistoryEntry> HistoryManager::getEntries(bool typed)
 	return entries;
 }
 
+QHash<QString, int> HistoryManager::getHostVisits(int limit)
+{
+	QHash<QString, int> hosts;
+	QSqlQuery query(QSqlDatabase::database(QLatin1String("browsingHistory")));
+	query.prepare(QString("SELECT \"hosts\".\"host\", COUNT(\"visits\".\"id\") AS \"amount\" FROM \"visits\" LEFT JOIN \"locations\" ON \"visits\".\"location\" = \"locations\".\"id\" LEFT JOIN \"hosts\" ON \"locations\".\"host\" = \"hosts\".\"id\" GROUP BY \"hosts\".\"host\" ORDER BY \"amount\" DESC LIMIT %1;").arg(limit));
+	query.exec();
+
+	while (query.next())
+	{
+		const QString host = query.record().value(QLatin1String("host")).toString();
+
+		if (!host.isEmpty())
+		{
+			hosts[host] = query.record().value(QLatin1String("amount")).toInt();
+		}
+	}
+
+	return hosts;
+}
+
+QSet<QString> HistoryManager::getSecureHosts()
+{
+	QSet<QString> hosts;
+	QSqlQuery query(QSqlDatabase::database(QLatin1String("browsingHistory")));
+	query.prepare(QLatin1String("SELECT DISTINCT \"hosts\".\"host\" FROM \"locations\" LEFT JOIN \"hosts\" ON \"locations\".\"host\" = \"hosts\".\"id\" WHERE \"locations\".\"scheme\" = 'https';"));
+	query.exec();
+
+	while (query.next())
+	{
+		const QString host = query.record().value(QLatin1String("host")).toString();
+
+		if (!host.isEmpty())
+		{
+			hosts.insert(host);
+		}
+	}
+
+	return hosts;
+}
+
+QList<QUrl> HistoryManager::getTransitions(const QUrl &url, int limit)
+{
+	QUrl simplifiedUrl(url);
+	simplifiedUrl.setHost(QString());
+
+	QList<QUrl> urls;
+	QSqlQuery query(QSqlDatabase::database(QLatin1String("browsingHistory")));
+	query.prepare(QString("SELECT \"locations\".\"scheme\", \"locations\".\"path\", \"hosts\".\"host\", COUNT(\"next\".\"id\") AS \"amount\" FROM \"visits\" AS \"current\" INNER JOIN \"visits\" AS \"next\" ON \"next\".\"id\" = (\"current\".\"id\" + 1) LEFT JOIN \"locations\" ON \"next\".\"location\" = \"locations\".\"id\" LEFT JOIN \"hosts\" ON \"locations\".\"host\" = \"hosts\".\"id\" WHERE \"current\".\"location\" = (SELECT \"locations\".\"id\" FROM \"locations\" LEFT JOIN \"hosts\" ON \"locations\".\"host\" = \"hosts\".\"id\" WHERE \"hosts\".\"host\" = ? AND \"locations\".\"scheme\" = ? AND \"locations\".\"path\" = ?) AND \"next\".\"location\" != \"current\".\"location\" AND (\"next\".\"time\" - \"current\".\"time\") < 1800 GROUP BY \"next\".\"location\" HAVING \"amount\" > 1 ORDER BY \"amount\" DESC LIMIT %1;").arg(limit));
+	query.bindValue(0, url.host());
+	query.bindValue(1, url.scheme());
+	query.bindValue(2, simplifiedUrl.toString(QUrl::RemovePassword | QUrl::RemoveScheme | QUrl::NormalizePathSegments | QUrl::PreferLocalFile | QUrl::FullyDecoded));
+	query.exec();
+
+	while (query.next())
+	{
+		QUrl transitionUrl;
+		transitionUrl.setUrl(query.record().value(QLatin1String("scheme")).toString() + QLatin1String("://") + query.record().value(QLatin1String("host")).toString() + query.record().value(QLatin1String("path")).toString(), QUrl::TolerantMode);
+
+		urls.append(transitionUrl);
+	}
+
+	return urls;
+}
+
 qint64 HistoryManager::getRecord(const QLatin1String &table, const QVariantHash &values)
 {
 	const QStringList keys = values.keys();
@@ -309,6 +379,13 @@ qint64 HistoryManager::getRecord(const QLatin1String &table, const QVariantHash
 
 qint64 HistoryManager::getLocation(const QUrl &url)
 {
+	const quint64 fingerprint = Utils::getUrlFingerprint(url, true);
+
+	if (m_locations.contains(fingerprint))
+	{
+		return m_locations[fingerprint];
+	}
+
 	QVariantHash hostsRecord;
 	hostsRecord[QLatin1String("host")] = url.host();
 
@@ -320,7 +397,14 @@ qint64 HistoryManager::getLocation(const QUrl &url)
 	locationsRecord[QLatin1String("scheme")] = url.scheme();
 	locationsRecord[QLatin1String("path")] = simplifiedUrl.toString(QUrl::RemovePassword | QUrl::RemoveScheme | QUrl::NormalizePathSegments | QUrl::PreferLocalFile | QUrl::FullyDecoded);
 
-	return getRecord(QLatin1String("locations"), locationsRecord);
+	const qint64 location = getRecord(QLatin1String("locations"), locationsRecord);
+
+	if (location > 0)
+	{
+		m_locations[fingerprint] = location;
+	}
+
+	return location;
 }
 
 qint64 HistoryManager::getIcon(const QIcon &icon)
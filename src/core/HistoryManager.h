@@ -22,6 +22,8 @@
 
 #include <QtCore/QObject>
 #include <QtCore/QDateTime>
+#include <QtCore/QHash>
+#include <QtCore/QSet>
 #include <QtCore/QUrl>
 #include <QtGui/QIcon>
 #include <QtSql/QSqlRecord>
@@ -52,6 +54,9 @@ public:
 	static HistoryManager* getInstance();
 	static HistoryEntry getEntry(qint64 entry);
 	static QList<HistoryEntry> getEntries(bool typed = false);
+	static QHash<QString, int> getHostVisits(int limit = 500);
+	static QSet<QString> getSecureHosts();
+	static QList<QUrl> getTransitions(const QUrl &url, int limit = 3);
 	static qint64 addEntry(const QUrl &url, const QString &title, const QIcon &icon, bool typed = false);
 	static bool updateEntry(qint64 entry, const QUrl &url, const QString &title, const QIcon &icon);
 	static bool removeEntry(qint64 entry);
@@ -76,6 +81,7 @@ private:
 	int m_dayTimer;
 
 	static HistoryManager *m_instance;
+	static QHash<quint64, qint64> m_locations;
 	static bool m_enabled;
 
 signals:
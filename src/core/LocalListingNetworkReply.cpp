@@ -18,20 +18,19 @@
 **************************************************************************/
 
 #include "LocalListingNetworkReply.h"
-#include "Utils.h"
+#include "LocalListingThread.h"
 
-#include <QtCore/QBuffer>
 #include <QtCore/QDir>
 #include <QtCore/QFileInfo>
-#include <QtCore/QMimeDatabase>
+#include <QtCore/QTextStream>
 #include <QtCore/QTimer>
 #include <QtGui/QGuiApplication>
-#include <QtGui/QIcon>
 
 namespace Otter
 {
 
 LocalListingNetworkReply::LocalListingNetworkReply(QObject *parent, const QNetworkRequest &request) : QNetworkReply(parent),
+	m_thread(new LocalListingThread(request.url().toLocalFile(), this)),
 	m_offset(0)
 {
 	setRequest(request);
@@ -45,7 +44,6 @@ LocalListingNetworkReply::LocalListingNetworkReply(QObject *parent, const QNetwo
 	stream.setCodec("UTF-8");
 
 	QDir directory(request.url().toLocalFile());
-	const QFileInfoList entries = directory.entryInfoList((QDir::AllEntries | QDir::Hidden), (QDir::Name | QDir::DirsFirst));
 	QStringList navigation;
 
 	do
@@ -63,19 +61,6 @@ LocalListingNetworkReply::LocalListingNetworkReply(QObject *parent, const QNetwo
 	variables[QLatin1String("header_type")] = tr("Type");
 	variables[QLatin1String("header_size")] = tr("Size");
 	variables[QLatin1String("header_date")] = tr("Date");
-	variables[QLatin1String("body")] = QString();
-
-	QMimeDatabase database;
-
-	for (int i = 0; i < entries.count(); ++i)
-	{
-		const QMimeType mimeType = database.mimeTypeForFile(entries.at(i).canonicalFilePath());
-		QByteArray byteArray;
-		QBuffer buffer(&byteArray);
-		QIcon::fromTheme(mimeType.iconName(), Utils::getIcon(entries.at(i).isDir() ? QLatin1String("inode-directory") : QLatin1String("unknown"))).pixmap(16, 16).save(&buffer, "PNG");
-
-		variables[QLatin1String("body")].append(QString("<tr>\n<td><a href=\"file://%1\"><img src=\"data:image/png;base64,%2\" alt=\"\"> %3</a></td>\n<td>%4</td>\n<td>%5</td>\n<td>%6</td>\n</tr>\n").arg(entries.at(i).filePath()).arg(QString(byteArray.toBase64())).arg(entries.at(i).fileName()).arg(mimeType.comment()).arg(entries.at(i).isDir() ? QString() : Utils::formatUnit(entries.at(i).size(), false, 2)).arg(entries.at(i).lastModified().toString()));
-	}
 
 	QString html = stream.readAll();
 	QHash<QString, QString>::iterator iterator;
@@ -85,17 +70,78 @@ LocalListingNetworkReply::LocalListingNetworkReply(QObject *parent, const QNetwo
 		html.replace(QString("{%1}").arg(iterator.key()), iterator.value());
 	}
 
-	m_content = html.toUtf8();
+	const int bodyPosition = html.indexOf(QLatin1String("{body}"));
+
+	m_content = html.left(bodyPosition).toUtf8();
+	m_footer = html.mid(bodyPosition + 6).toUtf8();
 
 	setHeader(QNetworkRequest::ContentTypeHeader, QVariant("text/html; charset=UTF-8"));
-	setHeader(QNetworkRequest::ContentLengthHeader, QVariant(m_content.size()));
+
+	connect(m_thread, SIGNAL(entriesRead(QByteArray)), this, SLOT(entriesRead(QByteArray)));
+	connect(m_thread, SIGNAL(finished()), this, SLOT(listingFinished()));
+
+	m_thread->start();
 
 	QTimer::singleShot(0, this, SIGNAL(readyRead()));
-	QTimer::singleShot(0, this, SIGNAL(finished()));
+}
+
+LocalListingNetworkReply::~LocalListingNetworkReply()
+{
+	m_thread->stop();
+	m_thread->wait();
 }
 
 void LocalListingNetworkReply::abort()
 {
+	if (isFinished())
+	{
+		return;
+	}
+
+	m_thread->stop();
+
+	disconnect(m_thread, 0, this, 0);
+
+	setError(OperationCanceledError, tr("Operation canceled"));
+	setFinished(true);
+
+	emit error(OperationCanceledError);
+	emit finished();
+}
+
+void LocalListingNetworkReply::appendData(const QByteArray &data)
+{
+	if (m_offset == m_content.size())
+	{
+		m_content.clear();
+
+		m_offset = 0;
+	}
+
+	m_content.append(data);
+
+	emit readyRead();
+}
+
+void LocalListingNetworkReply::entriesRead(const QByteArray &data)
+{
+	if (!isFinished())
+	{
+		appendData(data);
+	}
+}
+
+void LocalListingNetworkReply::listingFinished()
+{
+	if (isFinished())
+	{
+		return;
+	}
+
+	setFinished(true);
+	appendData(m_footer);
+
+	emit finished();
 }
 
 qint64 LocalListingNetworkReply::bytesAvailable() const
@@ -116,7 +162,7 @@ qint64 LocalListingNetworkReply::readData(char *data, qint64 maxSize)
 		return number;
 	}
 
-	return -1;
+	return (isFinished() ? -1 : 0);
 }
 
 bool LocalListingNetworkReply::isSequential() const
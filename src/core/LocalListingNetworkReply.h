@@ -26,10 +26,15 @@
 namespace Otter
 {
 
+class LocalListingThread;
+
 class LocalListingNetworkReply : public QNetworkReply
 {
+	Q_OBJECT
+
 public:
 	LocalListingNetworkReply(QObject *parent, const QNetworkRequest &request);
+	~LocalListingNetworkReply();
 
 	qint64 bytesAvailable() const;
 	qint64 readData(char *data, qint64 maxSize);
@@ -38,8 +43,17 @@ public:
 public slots:
 	void abort();
 
+protected:
+	void appendData(const QByteArray &data);
+
+protected slots:
+	void entriesRead(const QByteArray &data);
+	void listingFinished();
+
 private:
+	LocalListingThread *m_thread;
 	QByteArray m_content;
+	QByteArray m_footer;
 	qint64 m_offset;
 };
 
@@ -0,0 +1,103 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2013 - 2014 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "LocalListingThread.h"
+#include "ResourceNetworkReply.h"
+#include "Utils.h"
+
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QDirIterator>
+#include <QtCore/QMimeDatabase>
+#include <QtCore/QUrl>
+
+#include <algorithm>
+
+namespace Otter
+{
+
+LocalListingThread::LocalListingThread(const QString &path, QObject *parent) : QThread(parent),
+	m_path(path),
+	m_isStopped(0)
+{
+}
+
+void LocalListingThread::stop()
+{
+	m_isStopped.fetchAndStoreOrdered(1);
+}
+
+void LocalListingThread::run()
+{
+	QDirIterator iterator(m_path, (QDir::AllEntries | QDir::Hidden));
+	QFileInfoList entries;
+
+	while (iterator.hasNext())
+	{
+		if (m_isStopped.loadAcquire())
+		{
+			return;
+		}
+
+		iterator.next();
+
+		entries.append(iterator.fileInfo());
+	}
+
+	std::sort(entries.begin(), entries.end(), compareEntries);
+
+	for (int i = 0; i < entries.count(); i += 200)
+	{
+		if (m_isStopped.loadAcquire())
+		{
+			return;
+		}
+
+		emit entriesRead(formatEntries(entries.mid(i, 200)));
+	}
+}
+
+QByteArray LocalListingThread::formatEntries(const QFileInfoList &entries)
+{
+	QMimeDatabase database;
+	QString rows;
+
+	for (int i = 0; i < entries.count(); ++i)
+	{
+		const QFileInfo &entry = entries.at(i);
+		const QMimeType mimeType = (entry.isDir() ? database.mimeTypeForName(QLatin1String("inode/directory")) : database.mimeTypeForFile(entry, QMimeDatabase::MatchExtension));
+		const QString iconName = (mimeType.iconName().isEmpty() ? QLatin1String("unknown") : mimeType.iconName());
+
+		rows.append(QString("<tr>\n<td><a href=\"%1\"><img src=\"%2\" alt=\"\"> %3</a></td>\n<td>%4</td>\n<td>%5</td>\n<td>%6</td>\n</tr>\n").arg(QString(QUrl::fromLocalFile(entry.filePath()).toEncoded())).arg(ResourceNetworkReply::getIconUrl(iconName).toString(QUrl::FullyEncoded)).arg(entry.fileName().toHtmlEscaped()).arg(mimeType.comment().toHtmlEscaped()).arg(entry.isDir() ? QString() : Utils::formatUnit(entry.size(), false, 2)).arg(entry.lastModified().toString()));
+	}
+
+	return rows.toUtf8();
+}
+
+bool LocalListingThread::compareEntries(const QFileInfo &first, const QFileInfo &second)
+{
+	if (first.isDir() != second.isDir())
+	{
+		return first.isDir();
+	}
+
+	return (QString::localeAwareCompare(first.fileName(), second.fileName()) < 0);
+}
+
+}
@@ -0,0 +1,255 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2013 - 2014 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "LocalTextNetworkReply.h"
+#include "SettingsManager.h"
+#include "Utils.h"
+
+#include <QtCore/QMimeDatabase>
+#include <QtCore/QTextStream>
+#include <QtCore/QTimer>
+#include <QtCore/QUrlQuery>
+#include <QtGui/QGuiApplication>
+
+namespace Otter
+{
+
+const qint64 chunkSize = 1048576;
+const qint64 lineSearchSize = 65536;
+
+LocalTextNetworkReply::LocalTextNetworkReply(QObject *parent, const QNetworkRequest &request) : QNetworkReply(parent),
+	m_file(request.url().toLocalFile()),
+	m_codec(NULL),
+	m_offset(0),
+	m_unitSize(1),
+	m_isBigEndian(false)
+{
+	setRequest(request);
+	setUrl(request.url());
+
+	open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+
+	if (!m_file.open(QIODevice::ReadOnly))
+	{
+		setError(ContentAccessDenied, m_file.errorString());
+
+		QTimer::singleShot(0, this, SIGNAL(finished()));
+
+		return;
+	}
+
+	const QByteArray header = m_file.peek(4);
+
+	m_codec = QTextCodec::codecForUtfText(header, QTextCodec::codecForLocale());
+
+	if (m_codec->name().startsWith("UTF-16"))
+	{
+		m_unitSize = 2;
+		m_isBigEndian = (m_codec->name() == "UTF-16BE");
+	}
+
+	const QUrlQuery query(request.url());
+	const qint64 size = m_file.size();
+	const qint64 start = ((query.queryItemValue(QLatin1String("offset")).toLongLong() > 0) ? getLineStart(qMin(query.queryItemValue(QLatin1String("offset")).toLongLong(), size)) : 0);
+	const qint64 end = (((start + chunkSize) < size) ? getLineStart(start + chunkSize) : size);
+	const QByteArray chunk = readChunk(start, end);
+
+	if (query.queryItemValue(QLatin1String("raw")) == QLatin1String("1"))
+	{
+		m_content = chunk;
+
+		setHeader(QNetworkRequest::ContentTypeHeader, QVariant("text/plain; charset=UTF-8"));
+
+		if (end < size)
+		{
+			setRawHeader(QByteArray("X-Next-Chunk"), getChunkUrl(end, true).toEncoded());
+		}
+	}
+	else
+	{
+		QFile file(QLatin1String(":/files/text.html"));
+		file.open(QIODevice::ReadOnly | QIODevice::Text);
+
+		QTextStream stream(&file);
+		stream.setCodec("UTF-8");
+
+		QStringList navigation;
+
+		if (start > 0)
+		{
+			navigation.append(QString("<a href=\"%1\">%2</a>").arg(QString(getChunkUrl(0).toEncoded()).toHtmlEscaped()).arg(tr("First")));
+			navigation.append(QString("<a href=\"%1\">%2</a>").arg(QString(getChunkUrl(qMax(qint64(0), (start - chunkSize))).toEncoded()).toHtmlEscaped()).arg(tr("Previous")));
+		}
+
+		if (end < size)
+		{
+			navigation.append(QString("<a href=\"%1\">%2</a>").arg(QString(getChunkUrl(end).toEncoded()).toHtmlEscaped()).arg(tr("Next")));
+			navigation.append(QString("<a href=\"%1\">%2</a>").arg(QString(getChunkUrl(qMax(qint64(0), (size - chunkSize))).toEncoded()).toHtmlEscaped()).arg(tr("Last")));
+		}
+
+		QHash<QString, QString> variables;
+		variables[QLatin1String("title")] = QFileInfo(m_file).canonicalFilePath().toHtmlEscaped();
+		variables[QLatin1String("description")] = tr("Showing %1 - %2 of %3").arg(Utils::formatUnit(start, false, 2)).arg(Utils::formatUnit(end, false, 2)).arg(Utils::formatUnit(size, false, 2));
+		variables[QLatin1String("dir")] = (QGuiApplication::isLeftToRight() ? QLatin1String("ltr") : QLatin1String("rtl"));
+		variables[QLatin1String("navigation")] = navigation.join(QLatin1String(" | "));
+		variables[QLatin1String("next")] = ((end < size) ? QString(getChunkUrl(end, true).toEncoded()).toHtmlEscaped() : QString());
+
+		QString html = stream.readAll();
+		QHash<QString, QString>::iterator iterator;
+
+		for (iterator = variables.begin(); iterator != variables.end(); ++iterator)
+		{
+			html.replace(QString("{%1}").arg(iterator.key()), iterator.value());
+		}
+
+		html.replace(QLatin1String("{body}"), QString::fromUtf8(chunk).toHtmlEscaped());
+
+		m_content = html.toUtf8();
+
+		setHeader(QNetworkRequest::ContentTypeHeader, QVariant("text/html; charset=UTF-8"));
+	}
+
+	m_file.close();
+
+	setHeader(QNetworkRequest::ContentLengthHeader, QVariant(m_content.size()));
+
+	QTimer::singleShot(0, this, SIGNAL(readyRead()));
+	QTimer::singleShot(0, this, SIGNAL(finished()));
+}
+
+void LocalTextNetworkReply::abort()
+{
+}
+
+QByteArray LocalTextNetworkReply::readChunk(qint64 start, qint64 end)
+{
+	if (end <= start)
+	{
+		return QByteArray();
+	}
+
+	uchar *data = m_file.map(start, (end - start));
+
+	if (!data)
+	{
+		return QByteArray();
+	}
+
+	const QByteArray chunk(reinterpret_cast<const char*>(data), (end - start));
+
+	m_file.unmap(data);
+
+	return ((m_codec->name() == "UTF-8") ? chunk : m_codec->toUnicode(chunk).toUtf8());
+}
+
+QUrl LocalTextNetworkReply::getChunkUrl(qint64 offset, bool raw) const
+{
+	QUrlQuery query;
+	query.addQueryItem(QLatin1String("offset"), QString::number(offset));
+
+	if (raw)
+	{
+		query.addQueryItem(QLatin1String("raw"), QLatin1String("1"));
+	}
+
+	QUrl url(request().url());
+	url.setQuery(query);
+
+	return url;
+}
+
+qint64 LocalTextNetworkReply::getLineStart(qint64 position)
+{
+	const qint64 size = m_file.size();
+
+	if (position <= 0 || position >= size)
+	{
+		return qBound(qint64(0), position, size);
+	}
+
+	position -= (position % m_unitSize);
+
+	const qint64 length = qMin(lineSearchSize, (size - position));
+	uchar *data = m_file.map(position, length);
+
+	if (!data)
+	{
+		return position;
+	}
+
+	qint64 lineStart = position;
+
+	for (qint64 i = 0; (i + m_unitSize) <= length; i += m_unitSize)
+	{
+		const bool isNewLine = ((m_unitSize == 1) ? (data[i] == '\n') : (m_isBigEndian ? (data[i] == 0 && data[i + 1] == '\n') : (data[i] == '\n' && data[i + 1] == 0)));
+
+		if (isNewLine)
+		{
+			lineStart = (position + i + m_unitSize);
+
+			break;
+		}
+	}
+
+	m_file.unmap(data);
+
+	return lineStart;
+}
+
+qint64 LocalTextNetworkReply::bytesAvailable() const
+{
+	return (m_content.size() - m_offset);
+}
+
+qint64 LocalTextNetworkReply::readData(char *data, qint64 maxSize)
+{
+	if (m_offset < m_content.size())
+	{
+		qint64 number = qMin(maxSize, m_content.size() - m_offset);
+
+		memcpy(data, (m_content.constData() + m_offset), number);
+
+		m_offset += number;
+
+		return number;
+	}
+
+	return -1;
+}
+
+bool LocalTextNetworkReply::isSequential() const
+{
+	return true;
+}
+
+bool LocalTextNetworkReply::canHandle(const QFileInfo &fileInfo)
+{
+	const qint64 limit = (SettingsManager::getValue(QLatin1String("Content/LargeTextFileLimit")).toLongLong() * 1024);
+
+	if (limit <= 0 || !fileInfo.isFile() || fileInfo.size() <= limit)
+	{
+		return false;
+	}
+
+	const QMimeType mimeType = QMimeDatabase().mimeTypeForFile(fileInfo);
+
+	return (mimeType.inherits(QLatin1String("text/plain")) && !mimeType.inherits(QLatin1String("text/html")) && !mimeType.inherits(QLatin1String("application/xml")));
+}
+
+}
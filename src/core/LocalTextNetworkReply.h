@@ -0,0 +1,62 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2013 - 2014 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_LOCALTEXTNETWORKREPLY_H
+#define OTTER_LOCALTEXTNETWORKREPLY_H
+
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QTextCodec>
+#include <QtNetwork/QNetworkReply>
+
+namespace Otter
+{
+
+class LocalTextNetworkReply : public QNetworkReply
+{
+	Q_OBJECT
+
+public:
+	LocalTextNetworkReply(QObject *parent, const QNetworkRequest &request);
+
+	qint64 bytesAvailable() const;
+	qint64 readData(char *data, qint64 maxSize);
+	bool isSequential() const;
+	static bool canHandle(const QFileInfo &fileInfo);
+
+public slots:
+	void abort();
+
+protected:
+	QByteArray readChunk(qint64 start, qint64 end);
+	QUrl getChunkUrl(qint64 offset, bool raw = false) const;
+	qint64 getLineStart(qint64 position);
+
+private:
+	QFile m_file;
+	QByteArray m_content;
+	QTextCodec *m_codec;
+	qint64 m_offset;
+	int m_unitSize;
+	bool m_isBigEndian;
+};
+
+}
+
+#endif
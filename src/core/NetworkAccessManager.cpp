@@ -18,36 +18,115 @@
 **************************************************************************/
 
 #include "NetworkAccessManager.h"
+#include "BlockedNetworkReply.h"
+#include "ContentBlockingManager.h"
 #include "CookieJar.h"
 #include "LocalListingNetworkReply.h"
+#include "LocalTextNetworkReply.h"
 #include "NetworkCache.h"
+#include "PreconnectManager.h"
+#include "PrefetchManager.h"
+#include "ResourceNetworkReply.h"
+#include "ScheduledNetworkReply.h"
 #include "SessionsManager.h"
 #include "SettingsManager.h"
+#include "SnapshotNetworkReply.h"
+#include "SnapshotsManager.h"
 #include "../ui/AuthenticationDialog.h"
 #include "../ui/ContentsWidget.h"
 
-#include <QtCore/QEventLoop>
 #include <QtCore/QFileInfo>
+#include <QtCore/QUrlQuery>
 #include <QtWidgets/QMessageBox>
 
 namespace Otter
 {
 
+QList<NetworkAccessManager*> NetworkAccessManager::m_managers;
+QList<NetworkAccessManager*> NetworkAccessManager::m_simpleManagers;
+QNetworkAccessManager* NetworkAccessManager::m_transport = NULL;
+QNetworkAccessManager* NetworkAccessManager::m_privateTransport = NULL;
 CookieJar* NetworkAccessManager::m_cookieJar = NULL;
 QNetworkCookieJar* NetworkAccessManager::m_privateCookieJar = NULL;
 NetworkCache* NetworkAccessManager::m_cache = NULL;
+QHash<QString, QPair<QString, QString> > NetworkAccessManager::m_credentials;
+QHash<QString, QList<QSslError> > NetworkAccessManager::m_sslExceptions;
+QHash<QString, QList<QSslError> > NetworkAccessManager::m_pendingSslErrors;
+QSet<QString> NetworkAccessManager::m_pendingPrompts;
+QMap<int, QList<ScheduledNetworkReply*> > NetworkAccessManager::m_scheduledReplies;
+QHash<QString, int> NetworkAccessManager::m_hostRequests;
+ContentsWidget* NetworkAccessManager::m_activeWidget = NULL;
+int NetworkAccessManager::m_runningRequests = 0;
+int NetworkAccessManager::m_requestsLimit = 32;
+int NetworkAccessManager::m_hostRequestsLimit = 6;
+int NetworkAccessManager::m_http1Requests = 0;
+int NetworkAccessManager::m_spdyRequests = 0;
+int NetworkAccessManager::m_http2Requests = 0;
+int NetworkAccessManager::m_secureConnections = 0;
+int NetworkAccessManager::m_reusedSecureConnections = 0;
+
+NetworkReplyStatistics::NetworkReplyStatistics(QNetworkReply *reply, int generation, NetworkAccessManager *parent) : QObject(parent),
+	reply(reply),
+	bytesReceived(0),
+	recordIdentifier(0),
+	recordIndex(-1),
+	generation(generation),
+	hasBytesTotal(false),
+	isEncrypted(false),
+	m_manager(parent)
+{
+	connect(reply, SIGNAL(downloadProgress(qint64,qint64)), this, SLOT(replyDownloadProgress(qint64,qint64)));
+	connect(reply, SIGNAL(metaDataChanged()), this, SLOT(replyMetaDataChanged()));
+#if QT_VERSION >= 0x050100
+	connect(reply, SIGNAL(encrypted()), this, SLOT(replyEncrypted()));
+#endif
+	connect(reply, SIGNAL(finished()), this, SLOT(replyFinished()));
+	connect(reply, SIGNAL(destroyed()), this, SLOT(deleteLater()));
+}
+
+void NetworkReplyStatistics::replyDownloadProgress(qint64 received, qint64 total)
+{
+	m_manager->updateReplyProgress(this, received, total);
+}
+
+void NetworkReplyStatistics::replyMetaDataChanged()
+{
+	m_manager->updateReplyHeaders(this);
+}
+
+void NetworkReplyStatistics::replyEncrypted()
+{
+	m_manager->updateReplyEncrypted(this);
+}
+
+void NetworkReplyStatistics::replyFinished()
+{
+	disconnect(reply, NULL, this, NULL);
+
+	m_manager->updateReplyFinished(this);
+
+	deleteLater();
+}
 
 NetworkAccessManager::NetworkAccessManager(bool privateWindow, bool simpleMode, ContentsWidget *widget) : QNetworkAccessManager(widget),
 	m_widget(widget),
 	m_mainReply(NULL),
+	m_recordsCounter(0),
 	m_speed(0),
 	m_bytesReceivedDifference(0),
 	m_bytesReceived(0),
 	m_bytesTotal(0),
 	m_doNotTrackPolicy(SkipTrackPolicy),
+	m_requestClass(PageRequestClass),
 	m_finishedRequests(0),
 	m_startedRequests(0),
+	m_activeReplies(0),
+	m_generation(0),
+	m_recordsLimit(0),
+	m_recordsPosition(0),
 	m_updateTimer(0),
+	m_areStatusUpdatesEnabled(false),
+	m_isPrivate(privateWindow),
 	m_simpleMode(simpleMode)
 {
 	QNetworkCookieJar *cookieJar = getCookieJar(privateWindow);
@@ -56,23 +135,78 @@ NetworkAccessManager::NetworkAccessManager(bool privateWindow, bool simpleMode,
 
 	cookieJar->setParent(QCoreApplication::instance());
 
-	if (!privateWindow)
-	{
-		QNetworkDiskCache *cache = getCache();
+	optionChanged(QLatin1String("Browser/DoNotTrackPolicy"), SettingsManager::getValue(QLatin1String("Browser/DoNotTrackPolicy")));
+	optionChanged(QLatin1String("Network/MaximumRequests"), SettingsManager::getValue(QLatin1String("Network/MaximumRequests")));
+	optionChanged(QLatin1String("Network/MaximumRequestsPerHost"), SettingsManager::getValue(QLatin1String("Network/MaximumRequestsPerHost")));
 
-		setCache(cache);
+	if (!simpleMode)
+	{
+		if (!privateWindow)
+		{
+			optionChanged(QLatin1String("Network/RequestLogSize"), SettingsManager::getValue(QLatin1String("Network/RequestLogSize")));
+		}
 
-		cache->setParent(QCoreApplication::instance());
+		m_managers.append(this);
+	}
+	else
+	{
+		m_simpleManagers.append(this);
 	}
-
-	optionChanged(QLatin1String("Browser/DoNotTrackPolicy"), SettingsManager::getValue(QLatin1String("Browser/DoNotTrackPolicy")));
 
 	connect(SettingsManager::getInstance(), SIGNAL(valueChanged(QString,QVariant)), this, SLOT(optionChanged(QString,QVariant)));
 	connect(this, SIGNAL(finished(QNetworkReply*)), SLOT(requestFinished(QNetworkReply*)));
-	connect(this, SIGNAL(authenticationRequired(QNetworkReply*,QAuthenticator*)), this, SLOT(handleAuthenticationRequired(QNetworkReply*,QAuthenticator*)));
+	connect(getTransport(privateWindow), SIGNAL(authenticationRequired(QNetworkReply*,QAuthenticator*)), this, SLOT(handleAuthenticationRequired(QNetworkReply*,QAuthenticator*)));
 	connect(this, SIGNAL(sslErrors(QNetworkReply*,QList<QSslError>)), this, SLOT(handleSslErrors(QNetworkReply*,QList<QSslError>)));
 }
 
+NetworkAccessManager::~NetworkAccessManager()
+{
+	m_managers.removeAll(this);
+	m_simpleManagers.removeAll(this);
+
+	const QList<QObject*> prompts = m_prompts.keys();
+
+	for (int i = 0; i < prompts.count(); ++i)
+	{
+		resolvePrompt(m_prompts.take(prompts.at(i)), false);
+
+		prompts.at(i)->deleteLater();
+	}
+
+	QMap<int, QList<ScheduledNetworkReply*> >::iterator iterator = m_scheduledReplies.begin();
+
+	while (iterator != m_scheduledReplies.end())
+	{
+		for (int i = (iterator.value().count() - 1); i >= 0; --i)
+		{
+			if (iterator.value().at(i)->getManager() == this)
+			{
+				iterator.value().removeAt(i);
+			}
+		}
+
+		if (iterator.value().isEmpty())
+		{
+			iterator = m_scheduledReplies.erase(iterator);
+		}
+		else
+		{
+			++iterator;
+		}
+	}
+
+	const QList<QObject*> replies = m_runningReplies.keys();
+
+	for (int i = 0; i < replies.count(); ++i)
+	{
+		disconnect(replies.at(i), NULL, this, NULL);
+
+		releaseRequest(replies.at(i));
+	}
+
+	dispatchRequests();
+}
+
 void NetworkAccessManager::resetStatistics()
 {
 	killTimer(m_updateTimer);
@@ -80,7 +214,6 @@ void NetworkAccessManager::resetStatistics()
 	updateStatus();
 
 	m_updateTimer = 0;
-	m_replies.clear();
 	m_mainReply = NULL;
 	m_speed = 0;
 	m_bytesReceivedDifference = 0;
@@ -88,6 +221,23 @@ void NetworkAccessManager::resetStatistics()
 	m_bytesTotal = 0;
 	m_finishedRequests = 0;
 	m_startedRequests = 0;
+	m_activeReplies = 0;
+
+	++m_generation;
+}
+
+void NetworkAccessManager::clearRecords()
+{
+	m_records.clear();
+
+	m_recordsPosition = 0;
+
+	emit recordsChanged();
+}
+
+void NetworkAccessManager::clearPageResources()
+{
+	m_pageResources.clear();
 }
 
 void NetworkAccessManager::clearCookies(int period)
@@ -120,11 +270,47 @@ void NetworkAccessManager::updateStatus()
 	emit statusChanged(m_finishedRequests, m_startedRequests, m_bytesReceived, m_bytesTotal, m_speed);
 }
 
-void NetworkAccessManager::downloadProgress(qint64 bytesReceived, qint64 bytesTotal)
+void NetworkAccessManager::setMainFrame(QObject *frame)
+{
+	m_mainFrame = frame;
+}
+
+void NetworkAccessManager::setRequestClass(RequestClass requestClass)
+{
+	m_requestClass = requestClass;
+}
+
+void NetworkAccessManager::setStatusUpdatesEnabled(bool enabled)
 {
-	QNetworkReply *reply = qobject_cast<QNetworkReply*>(sender());
+	if (enabled == m_areStatusUpdatesEnabled)
+	{
+		return;
+	}
+
+	m_areStatusUpdatesEnabled = enabled;
+
+	if (enabled)
+	{
+		m_bytesReceivedDifference = 0;
+
+		updateStatus();
+
+		if (m_activeReplies > 0 && m_updateTimer == 0)
+		{
+			m_updateTimer = startTimer(500);
+		}
+	}
+	else if (m_updateTimer != 0)
+	{
+		killTimer(m_updateTimer);
+
+		m_updateTimer = 0;
+	}
+}
 
-	if (reply && reply == m_mainReply)
+void NetworkAccessManager::updateReplyProgress(NetworkReplyStatistics *statistics, qint64 bytesReceived, qint64 bytesTotal)
+{
+	if (statistics->reply == m_mainReply)
 	{
 		if (bytesTotal > 0)
 		{
@@ -136,18 +322,30 @@ void NetworkAccessManager::downloadProgress(qint64 bytesReceived, qint64 bytesTo
 		}
 	}
 
-	if (!reply || !m_replies.contains(reply))
+	NetworkRequestRecord *record = getRecord(statistics);
+
+	if (record)
 	{
-		return;
+		if (record->firstByteTime < 0 && bytesReceived > 0)
+		{
+			record->firstByteTime = record->startTime.msecsTo(QDateTime::currentDateTime());
+		}
+
+		record->bytesReceived = bytesReceived;
 	}
 
-	const qint64 difference = (bytesReceived - m_replies[reply].first);
+	const qint64 difference = (bytesReceived - statistics->bytesReceived);
 
-	m_replies[reply].first = bytesReceived;
+	statistics->bytesReceived = bytesReceived;
+
+	if (statistics->generation != m_generation)
+	{
+		return;
+	}
 
-	if (!m_replies[reply].second && bytesTotal > 0)
+	if (!statistics->hasBytesTotal && bytesTotal > 0)
 	{
-		m_replies[reply].second = true;
+		statistics->hasBytesTotal = true;
 
 		m_bytesTotal += bytesTotal;
 	}
@@ -161,53 +359,211 @@ void NetworkAccessManager::downloadProgress(qint64 bytesReceived, qint64 bytesTo
 	m_bytesReceivedDifference += difference;
 }
 
+void NetworkAccessManager::updateReplyHeaders(NetworkReplyStatistics *statistics)
+{
+	NetworkRequestRecord *record = getRecord(statistics);
+
+	if (record && record->headersTime < 0)
+	{
+		record->headersTime = record->startTime.msecsTo(QDateTime::currentDateTime());
+		record->status = statistics->reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+		record->isFromCache = statistics->reply->attribute(QNetworkRequest::SourceIsFromCacheAttribute).toBool();
+		record->mimeType = statistics->reply->header(QNetworkRequest::ContentTypeHeader).toString().section(QLatin1Char(';'), 0, 0).trimmed();
+	}
+}
+
+void NetworkAccessManager::updateReplyEncrypted(NetworkReplyStatistics *statistics)
+{
+	statistics->isEncrypted = true;
+
+	NetworkRequestRecord *record = getRecord(statistics);
+
+	if (record && record->encryptedTime < 0)
+	{
+		record->encryptedTime = record->startTime.msecsTo(QDateTime::currentDateTime());
+	}
+}
+
+void NetworkAccessManager::updateReplyFinished(NetworkReplyStatistics *statistics)
+{
+	QNetworkReply *reply = statistics->reply;
+	const bool isFromCache = reply->attribute(QNetworkRequest::SourceIsFromCacheAttribute).toBool();
+	const bool isSecure = (reply->url().scheme() == QLatin1String("https"));
+	QByteArray protocol;
+
+	if (!isFromCache && reply->error() == QNetworkReply::NoError && (isSecure || reply->url().scheme() == QLatin1String("http")))
+	{
+		protocol = QByteArray("http/1.1");
+
+#if QT_VERSION >= 0x050800
+		if (reply->attribute(QNetworkRequest::HTTP2WasUsedAttribute).toBool())
+		{
+			protocol = QByteArray("h2");
+		}
+#endif
+#if QT_VERSION >= 0x050300
+		if (reply->attribute(QNetworkRequest::SpdyWasUsedAttribute).toBool())
+		{
+			protocol = QByteArray("spdy/3");
+		}
+#endif
+
+		if (protocol == QByteArray("h2"))
+		{
+			++m_http2Requests;
+		}
+		else if (protocol == QByteArray("spdy/3"))
+		{
+			++m_spdyRequests;
+		}
+		else
+		{
+			++m_http1Requests;
+		}
+
+		if (isSecure)
+		{
+			if (statistics->isEncrypted)
+			{
+				++m_secureConnections;
+			}
+			else
+			{
+				++m_reusedSecureConnections;
+			}
+		}
+	}
+
+	if (reply == m_mainReply && reply->error() == QNetworkReply::NoError)
+	{
+		PrefetchManager::recordNavigation(reply->request().url(), isFromCache);
+	}
+
+	NetworkRequestRecord *record = getRecord(statistics);
+
+	if (record)
+	{
+		record->protocol = protocol;
+		record->finishTime = record->startTime.msecsTo(QDateTime::currentDateTime());
+		record->status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+		record->isConnectionReused = (isSecure && !protocol.isEmpty() && !statistics->isEncrypted);
+		record->isFromCache = isFromCache;
+
+		if (record->mimeType.isEmpty())
+		{
+			record->mimeType = reply->header(QNetworkRequest::ContentTypeHeader).toString().section(QLatin1Char(';'), 0, 0).trimmed();
+		}
+
+		emit recordsChanged();
+	}
+
+	if (statistics->generation == m_generation)
+	{
+		--m_activeReplies;
+	}
+
+	statistics->generation = -1;
+}
+
 void NetworkAccessManager::requestFinished(QNetworkReply *reply)
 {
+	m_transportReplies.remove(reply);
+
+	if (reply == m_mainReply)
+	{
+		m_mainReply = NULL;
+	}
+
 	if (!m_simpleMode)
 	{
-		m_replies.remove(reply);
+		++m_finishedRequests;
 
-		if (m_replies.isEmpty())
+		if (m_activeReplies <= 0)
 		{
-			killTimer(m_updateTimer);
+			if (m_updateTimer != 0)
+			{
+				killTimer(m_updateTimer);
 
-			m_updateTimer = 0;
+				m_updateTimer = 0;
+			}
 
 			updateStatus();
 		}
 
-		++m_finishedRequests;
+		if (reply)
+		{
+			reply->deleteLater();
+		}
 	}
+}
 
-	if (!m_simpleMode && reply)
+void NetworkAccessManager::transportReplyFinished()
+{
+	if (sender())
 	{
-		disconnect(reply, SIGNAL(downloadProgress(qint64,qint64)), this, SLOT(downloadProgress(qint64,qint64)));
+		releaseRequest(sender());
+		dispatchRequests();
+	}
+}
+
+void NetworkAccessManager::transportReplyDestroyed(QObject *reply)
+{
+	m_transportReplies.remove(static_cast<QNetworkReply*>(reply));
+	m_authenticatedReplies.remove(static_cast<QNetworkReply*>(reply));
 
-		reply->deleteLater();
+	if (m_runningReplies.contains(reply))
+	{
+		releaseRequest(reply);
+		dispatchRequests();
 	}
 }
 
 void NetworkAccessManager::handleAuthenticationRequired(QNetworkReply *reply, QAuthenticator *authenticator)
 {
-	if (m_widget)
+	if (!m_transportReplies.contains(reply))
 	{
-		AuthenticationDialog dialog(reply->url(), authenticator, m_widget);
-		QEventLoop eventLoop;
+		return;
+	}
+
+	const QString key = QString("authentication:%1:%2://%3:%4/%5").arg(m_isPrivate ? QLatin1String("private") : QLatin1String("default")).arg(reply->url().scheme()).arg(reply->url().host()).arg(reply->url().port()).arg(authenticator->realm());
 
-		m_widget->showDialog(&dialog);
+	if (m_credentials.contains(key))
+	{
+		if (!m_authenticatedReplies.contains(reply))
+		{
+			authenticator->setUser(m_credentials[key].first);
+			authenticator->setPassword(m_credentials[key].second);
 
-		connect(&dialog, SIGNAL(finished(int)), &eventLoop, SLOT(quit()));
-		connect(this, SIGNAL(destroyed()), &eventLoop, SLOT(quit()));
+			m_authenticatedReplies.insert(reply);
 
-		eventLoop.exec();
+			return;
+		}
 
-		m_widget->hideDialog(&dialog);
+		m_credentials.remove(key);
 	}
-	else
+
+	m_authenticatedReplies.remove(reply);
+	m_waitingPrompts.insert(key);
+
+	if (reply == m_mainReply)
+	{
+		m_waitingNavigations.insert(key);
+	}
+	else if (!m_widget && !m_waitingUrls.contains(key, reply->url()))
 	{
-		AuthenticationDialog dialog(reply->url(), authenticator, SessionsManager::getActiveWindow());
-		dialog.exec();
+		m_waitingUrls.insert(key, reply->url());
+	}
+
+	if (m_pendingPrompts.contains(key))
+	{
+		return;
 	}
+
+	AuthenticationDialog *dialog = new AuthenticationDialog(reply->url(), *authenticator, (m_widget ? m_widget : SessionsManager::getActiveWindow()));
+
+	connect(dialog, SIGNAL(finished(int)), this, SLOT(authenticationDialogFinished(int)));
+
+	showPrompt(dialog, key);
 }
 
 void NetworkAccessManager::handleSslErrors(QNetworkReply *reply, const QList<QSslError> &errors)
@@ -229,35 +585,299 @@ void NetworkAccessManager::handleSslErrors(QNetworkReply *reply, const QList<QSs
 		return;
 	}
 
+	const QString key = QString("ssl:%1:%2:%3").arg(m_isPrivate ? QLatin1String("private") : QLatin1String("default")).arg(reply->url().host()).arg(reply->url().port(443));
+
+	if (m_sslExceptions.contains(key))
+	{
+		bool isAccepted = true;
+
+		for (int i = 0; i < errors.count(); ++i)
+		{
+			if (errors.at(i).error() != QSslError::NoError && !m_sslExceptions[key].contains(errors.at(i)))
+			{
+				isAccepted = false;
+
+				break;
+			}
+		}
+
+		if (isAccepted)
+		{
+			reply->ignoreSslErrors(errors);
+
+			return;
+		}
+	}
+
+	m_waitingPrompts.insert(key);
+
+	if (reply == m_mainReply)
+	{
+		m_waitingNavigations.insert(key);
+	}
+	else if (!m_widget && !m_waitingUrls.contains(key, reply->url()))
+	{
+		m_waitingUrls.insert(key, reply->url());
+	}
+
+	if (m_pendingPrompts.contains(key))
+	{
+		m_pendingSslErrors[key].append(errors);
+
+		return;
+	}
+
+	m_pendingSslErrors[key] = errors;
+
+	QMessageBox *dialog = new QMessageBox(QMessageBox::Warning, tr("Warning"), tr("SSL errors occured:\n\n%1\n\nDo you want to continue?").arg(messages.join('\n')), (QMessageBox::Yes | QMessageBox::No), (m_widget ? m_widget : SessionsManager::getActiveWindow()));
+	dialog->setModal(false);
+
+	connect(dialog, SIGNAL(finished(int)), this, SLOT(sslErrorsDialogFinished(int)));
+
+	showPrompt(dialog, key);
+}
+
+void NetworkAccessManager::authenticationDialogFinished(int result)
+{
+	AuthenticationDialog *dialog = qobject_cast<AuthenticationDialog*>(sender());
+
+	if (!dialog || !m_prompts.contains(dialog))
+	{
+		return;
+	}
+
+	const QString key = m_prompts.take(dialog);
+
+	if (result == QDialog::Accepted)
+	{
+		m_credentials[key] = qMakePair(dialog->getUser(), dialog->getPassword());
+	}
+
+	closePrompt(dialog);
+	resolvePrompt(key, (result == QDialog::Accepted));
+}
+
+void NetworkAccessManager::sslErrorsDialogFinished(int result)
+{
+	Q_UNUSED(result)
+
+	QMessageBox *dialog = qobject_cast<QMessageBox*>(sender());
+
+	if (!dialog || !m_prompts.contains(dialog))
+	{
+		return;
+	}
+
+	const QString key = m_prompts.take(dialog);
+	const bool isAccepted = (dialog->buttonRole(dialog->clickedButton()) == QMessageBox::YesRole);
+
+	if (isAccepted)
+	{
+		m_sslExceptions[key].append(m_pendingSslErrors.value(key));
+	}
+
+	closePrompt(dialog);
+	resolvePrompt(key, isAccepted);
+}
+
+void NetworkAccessManager::promptDestroyed(QObject *dialog)
+{
+	if (m_prompts.contains(dialog))
+	{
+		resolvePrompt(m_prompts.take(dialog), false);
+	}
+}
+
+void NetworkAccessManager::showPrompt(QWidget *dialog, const QString &key)
+{
+	m_pendingPrompts.insert(key);
+	m_prompts[dialog] = key;
+
+	connect(dialog, SIGNAL(destroyed(QObject*)), this, SLOT(promptDestroyed(QObject*)));
+
 	if (m_widget)
 	{
-		QMessageBox dialog;
-		dialog.setModal(false);
-		dialog.setWindowTitle(tr("Warning"));
-		dialog.setText(tr("SSL errors occured:\n\n%1\n\nDo you want to continue?").arg(messages.join('\n')));
-		dialog.setIcon(QMessageBox::Warning);
-		dialog.setStandardButtons(QMessageBox::Yes | QMessageBox::No);
+		m_widget->showDialog(dialog);
+	}
+	else
+	{
+		dialog->show();
+	}
+}
 
-		QEventLoop eventLoop;
+void NetworkAccessManager::closePrompt(QWidget *dialog)
+{
+	if (m_widget)
+	{
+		m_widget->hideDialog(dialog);
+	}
 
-		m_widget->showDialog(&dialog);
+	dialog->deleteLater();
+}
 
-		connect(&dialog, SIGNAL(finished(int)), &eventLoop, SLOT(quit()));
-		connect(this, SIGNAL(destroyed()), &eventLoop, SLOT(quit()));
+void NetworkAccessManager::resolvePrompt(const QString &key, bool accepted)
+{
+	m_pendingPrompts.remove(key);
+	m_pendingSslErrors.remove(key);
 
-		eventLoop.exec();
+	const QList<NetworkAccessManager*> managers = (m_managers + m_simpleManagers);
 
-		m_widget->hideDialog(&dialog);
+	for (int i = 0; i < managers.count(); ++i)
+	{
+		NetworkAccessManager *manager = managers.at(i);
 
-		if (dialog.buttonRole(dialog.clickedButton()) == QMessageBox::YesRole)
+		if (!manager->m_waitingPrompts.remove(key))
 		{
-			reply->ignoreSslErrors(errors);
+			continue;
+		}
+
+		const QList<QUrl> urls = manager->m_waitingUrls.values(key);
+		const bool isNavigation = manager->m_waitingNavigations.remove(key);
+
+		manager->m_waitingUrls.remove(key);
+
+		if (!accepted)
+		{
+			continue;
+		}
+
+		if (isNavigation && manager->m_widget)
+		{
+			manager->m_widget->triggerAction(ReloadAction);
+		}
+
+		for (int j = 0; j < urls.count(); ++j)
+		{
+			emit manager->retryRequired(urls.at(j));
 		}
 	}
-	else if (QMessageBox::warning(SessionsManager::getActiveWindow(), tr("Warning"), tr("SSL errors occured:\n\n%1\n\nDo you want to continue?").arg(messages.join('\n')), (QMessageBox::Yes | QMessageBox::No)) == QMessageBox::Yes)
+}
+
+void NetworkAccessManager::startRequest(ScheduledNetworkReply *reply)
+{
+	QNetworkReply *transportReply = sendRequest(reply->operation(), reply->request(), NULL);
+
+	trackRequest(transportReply);
+
+	reply->setReply(transportReply);
+}
+
+void NetworkAccessManager::trackRequest(QNetworkReply *reply)
+{
+	const QString host = reply->request().url().host();
+
+	m_transportReplies.insert(reply);
+	m_runningReplies[reply] = host;
+
+	++m_runningRequests;
+
+	m_hostRequests[host] = (m_hostRequests.value(host, 0) + 1);
+
+	connect(reply, SIGNAL(finished()), this, SLOT(transportReplyFinished()));
+	connect(reply, SIGNAL(destroyed(QObject*)), this, SLOT(transportReplyDestroyed(QObject*)));
+}
+
+void NetworkAccessManager::releaseRequest(QObject *reply)
+{
+	if (!m_runningReplies.contains(reply))
 	{
-		reply->ignoreSslErrors(errors);
+		return;
+	}
+
+	const QString host = m_runningReplies.take(reply);
+
+	--m_runningRequests;
+
+	if (m_hostRequests.value(host, 0) > 1)
+	{
+		--m_hostRequests[host];
+	}
+	else
+	{
+		m_hostRequests.remove(host);
+	}
+}
+
+void NetworkAccessManager::scheduleRequest(ScheduledNetworkReply *reply)
+{
+	reply->setPriority(reply->getManager()->getRequestPriority(reply->getType()));
+
+	m_scheduledReplies[reply->getPriority()].append(reply);
+}
+
+void NetworkAccessManager::dispatchRequests()
+{
+	QMap<int, QList<ScheduledNetworkReply*> >::iterator iterator = m_scheduledReplies.begin();
+
+	while (m_runningRequests < m_requestsLimit && iterator != m_scheduledReplies.end())
+	{
+		QList<ScheduledNetworkReply*> &replies = iterator.value();
+		ScheduledNetworkReply *reply = NULL;
+
+		for (int i = 0; i < replies.count(); ++i)
+		{
+			if (m_hostRequests.value(replies.at(i)->getHost(), 0) < m_hostRequestsLimit)
+			{
+				reply = replies.takeAt(i);
+
+				break;
+			}
+		}
+
+		if (replies.isEmpty())
+		{
+			iterator = m_scheduledReplies.erase(iterator);
+		}
+		else if (!reply)
+		{
+			++iterator;
+		}
+
+		if (reply)
+		{
+			reply->getManager()->startRequest(reply);
+		}
+	}
+}
+
+void NetworkAccessManager::unscheduleRequest(ScheduledNetworkReply *reply)
+{
+	QMap<int, QList<ScheduledNetworkReply*> >::iterator iterator = m_scheduledReplies.find(reply->getPriority());
+
+	if (iterator == m_scheduledReplies.end())
+	{
+		return;
+	}
+
+	iterator.value().removeAll(reply);
+
+	if (iterator.value().isEmpty())
+	{
+		m_scheduledReplies.erase(iterator);
+	}
+}
+
+QNetworkReply* NetworkAccessManager::sendRequest(QNetworkAccessManager::Operation operation, const QNetworkRequest &request, QIODevice *outgoingData)
+{
+	QNetworkAccessManager *transport = getTransport(m_isPrivate);
+
+	switch (operation)
+	{
+		case HeadOperation:
+			return transport->head(request);
+		case GetOperation:
+			return transport->get(request);
+		case PutOperation:
+			return transport->put(request, outgoingData);
+		case PostOperation:
+			return transport->post(request, outgoingData);
+		case DeleteOperation:
+			return transport->deleteResource(request);
+		default:
+			break;
 	}
+
+	return transport->sendCustomRequest(request, request.attribute(QNetworkRequest::CustomVerbAttribute).toByteArray(), outgoingData);
 }
 
 QNetworkReply *NetworkAccessManager::createRequest(QNetworkAccessManager::Operation operation, const QNetworkRequest &request, QIODevice *outgoingData)
@@ -267,13 +887,53 @@ QNetworkReply *NetworkAccessManager::createRequest(QNetworkAccessManager::Operat
 		++m_startedRequests;
 	}
 
-	if (operation == GetOperation && request.url().isLocalFile() && QFileInfo(request.url().toLocalFile()).isDir())
+	const RequestType type = getRequestType(request);
+	const bool isNavigation = (!m_simpleMode && type == DocumentRequest && m_mainFrame && request.originatingObject() == m_mainFrame);
+
+	if (isNavigation)
+	{
+		m_baseUrl = request.url();
+
+		m_waitingNavigations.clear();
+	}
+
+	if (operation == GetOperation && request.url().isLocalFile())
+	{
+		const QFileInfo fileInfo(request.url().toLocalFile());
+
+		if (fileInfo.isDir())
+		{
+			return new LocalListingNetworkReply(this, request);
+		}
+
+		if ((isNavigation || (m_baseUrl.isLocalFile() && m_baseUrl.toLocalFile() == fileInfo.filePath() && QUrlQuery(request.url()).queryItemValue(QLatin1String("raw")) == QLatin1String("1"))) && LocalTextNetworkReply::canHandle(fileInfo))
+		{
+			return new LocalTextNetworkReply(this, request);
+		}
+	}
+
+	if (operation == GetOperation && request.url().scheme() == QLatin1String("otter") && (m_baseUrl.isLocalFile() || m_baseUrl.scheme() == QLatin1String("about")))
+	{
+		return new ResourceNetworkReply(this, request);
+	}
+
+	if (operation == GetOperation && SettingsManager::getValue(QLatin1String("Network/WorkOffline")).toBool() && (SnapshotsManager::hasResource(request.url()) || (!m_baseUrl.isEmpty() && SnapshotsManager::hasSnapshot(m_baseUrl))))
 	{
-		return new LocalListingNetworkReply(this, request);
+		return new SnapshotNetworkReply(this, request, (m_isPrivate ? NULL : getCache()));
 	}
 
 	QNetworkRequest mutableRequest(request);
 
+	if (SettingsManager::getValue(QLatin1String("Network/EnableHttp2")).toBool())
+	{
+#if QT_VERSION >= 0x050300
+		mutableRequest.setAttribute(QNetworkRequest::SpdyAllowedAttribute, true);
+#endif
+#if QT_VERSION >= 0x050800
+		mutableRequest.setAttribute(QNetworkRequest::HTTP2AllowedAttribute, true);
+#endif
+	}
+
 	if (SettingsManager::getValue(QLatin1String("Network/WorkOffline")).toBool())
 	{
 		mutableRequest.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::AlwaysCache);
@@ -284,20 +944,130 @@ QNetworkReply *NetworkAccessManager::createRequest(QNetworkAccessManager::Operat
 		}
 	}
 
-	QNetworkReply *reply = QNetworkAccessManager::createRequest(operation, mutableRequest, outgoingData);
+	if (!m_simpleMode)
+	{
+		const bool isForeground = (!m_widget || m_widget->isVisible());
+
+		if (isNavigation)
+		{
+			PreconnectManager::recordNavigation(mutableRequest.url());
+		}
+		else if (!m_baseUrl.isEmpty() && (mutableRequest.url().scheme() == QLatin1String("http") || mutableRequest.url().scheme() == QLatin1String("https")) && ContentBlockingManager::isBlocked(mutableRequest.url(), m_baseUrl, type))
+		{
+			return new BlockedNetworkReply(this, mutableRequest, operation);
+		}
+
+		if (operation == GetOperation && m_pageResources.count() < 2000 && (mutableRequest.url().scheme() == QLatin1String("http") || mutableRequest.url().scheme() == QLatin1String("https")))
+		{
+			m_pageResources.append(mutableRequest.url());
+		}
+
+		if (type == DocumentRequest || type == StyleSheetRequest || type == ScriptRequest)
+		{
+			mutableRequest.setPriority(isForeground ? QNetworkRequest::HighPriority : QNetworkRequest::NormalPriority);
+		}
+		else
+		{
+			mutableRequest.setPriority(isForeground ? QNetworkRequest::NormalPriority : QNetworkRequest::LowPriority);
+		}
+	}
+
+	const bool isScheduled = ((!m_simpleMode || m_requestClass != PageRequestClass) && (mutableRequest.url().scheme() == QLatin1String("http") || mutableRequest.url().scheme() == QLatin1String("https")));
+	QNetworkReply *reply = NULL;
+
+	if (isScheduled && !isNavigation && !outgoingData && !mutableRequest.attribute(QNetworkRequest::SynchronousRequestAttribute).toBool())
+	{
+		ScheduledNetworkReply *scheduledReply = new ScheduledNetworkReply(this, mutableRequest, operation, type);
+
+		scheduleRequest(scheduledReply);
+
+		reply = scheduledReply;
+
+		dispatchRequests();
+	}
+	else
+	{
+		reply = sendRequest(operation, mutableRequest, outgoingData);
+
+		if (isScheduled)
+		{
+			trackRequest(reply);
+		}
+		else
+		{
+			m_transportReplies.insert(reply);
+
+			connect(reply, SIGNAL(destroyed(QObject*)), this, SLOT(transportReplyDestroyed(QObject*)));
+		}
+	}
 
-	if (!m_mainReply)
+	if (isNavigation)
 	{
 		m_mainReply = reply;
 	}
 
 	if (!m_simpleMode)
 	{
-		m_replies[reply] = qMakePair(0, false);
+		NetworkReplyStatistics *statistics = new NetworkReplyStatistics(reply, m_generation, this);
+
+		++m_activeReplies;
+
+		if (m_recordsLimit > 0)
+		{
+			NetworkRequestRecord record;
+			record.url = mutableRequest.url();
+			record.startTime = QDateTime::currentDateTime();
+			record.identifier = ++m_recordsCounter;
+			record.type = getRequestType(mutableRequest);
+
+			switch (operation)
+			{
+				case HeadOperation:
+					record.method = QByteArray("HEAD");
+
+					break;
+				case GetOperation:
+					record.method = QByteArray("GET");
+
+					break;
+				case PutOperation:
+					record.method = QByteArray("PUT");
+
+					break;
+				case PostOperation:
+					record.method = QByteArray("POST");
+
+					break;
+				case DeleteOperation:
+					record.method = QByteArray("DELETE");
+
+					break;
+				default:
+					record.method = mutableRequest.attribute(QNetworkRequest::CustomVerbAttribute).toByteArray();
+
+					break;
+			}
+
+			int index = m_recordsPosition;
+
+			if (m_records.count() < m_recordsLimit)
+			{
+				index = m_records.count();
 
-		connect(reply, SIGNAL(downloadProgress(qint64,qint64)), this, SLOT(downloadProgress(qint64,qint64)));
+				m_records.append(record);
+			}
+			else
+			{
+				m_records[index] = record;
 
-		if (m_updateTimer == 0)
+				m_recordsPosition = ((m_recordsPosition + 1) % m_recordsLimit);
+			}
+
+			statistics->recordIndex = index;
+			statistics->recordIdentifier = record.identifier;
+		}
+
+		if (m_areStatusUpdatesEnabled && m_updateTimer == 0)
 		{
 			m_updateTimer = startTimer(500);
 		}
@@ -325,6 +1095,197 @@ void NetworkAccessManager::optionChanged(const QString &option, const QVariant &
 			m_doNotTrackPolicy = SkipTrackPolicy;
 		}
 	}
+	else if (option == QLatin1String("Network/MaximumRequests") && qMax(1, value.toInt()) != m_requestsLimit)
+	{
+		m_requestsLimit = qMax(1, value.toInt());
+
+		dispatchRequests();
+	}
+	else if (option == QLatin1String("Network/MaximumRequestsPerHost") && qMax(1, value.toInt()) != m_hostRequestsLimit)
+	{
+		m_hostRequestsLimit = qMax(1, value.toInt());
+
+		dispatchRequests();
+	}
+	else if (option == QLatin1String("Network/RequestLogSize") && !m_simpleMode && !m_isPrivate && value.toInt() != m_recordsLimit)
+	{
+		m_recordsLimit = qMax(0, value.toInt());
+
+		clearRecords();
+	}
+}
+
+NetworkRequestRecord* NetworkAccessManager::getRecord(NetworkReplyStatistics *statistics)
+{
+	if (statistics->recordIndex < 0 || statistics->recordIndex >= m_records.count() || m_records.at(statistics->recordIndex).identifier != statistics->recordIdentifier)
+	{
+		return NULL;
+	}
+
+	return &m_records[statistics->recordIndex];
+}
+
+QNetworkAccessManager* NetworkAccessManager::getTransport(bool privateTransport)
+{
+	QNetworkAccessManager *transport = (privateTransport ? m_privateTransport : m_transport);
+
+	if (!transport)
+	{
+		transport = new QNetworkAccessManager(QCoreApplication::instance());
+
+		QNetworkCookieJar *cookieJar = getCookieJar(privateTransport);
+
+		transport->setCookieJar(cookieJar);
+
+		cookieJar->setParent(QCoreApplication::instance());
+
+		if (!privateTransport)
+		{
+			QNetworkDiskCache *cache = getCache();
+
+			transport->setCache(cache);
+
+			cache->setParent(QCoreApplication::instance());
+		}
+
+		if (privateTransport)
+		{
+			m_privateTransport = transport;
+		}
+		else
+		{
+			m_transport = transport;
+		}
+	}
+
+	return transport;
+}
+
+void NetworkAccessManager::setActiveWidget(ContentsWidget *widget)
+{
+	if (widget == m_activeWidget)
+	{
+		return;
+	}
+
+	m_activeWidget = widget;
+
+	const QList<QList<ScheduledNetworkReply*> > buckets = m_scheduledReplies.values();
+
+	m_scheduledReplies.clear();
+
+	for (int i = 0; i < buckets.count(); ++i)
+	{
+		for (int j = 0; j < buckets.at(i).count(); ++j)
+		{
+			scheduleRequest(buckets.at(i).at(j));
+		}
+	}
+
+	dispatchRequests();
+}
+
+ContentsWidget* NetworkAccessManager::getWidget() const
+{
+	return m_widget;
+}
+
+ContentsWidget* NetworkAccessManager::getActiveWidget()
+{
+	return m_activeWidget;
+}
+
+QList<NetworkRequestRecord> NetworkAccessManager::getRecords() const
+{
+	QList<NetworkRequestRecord> records;
+
+	for (int i = m_recordsPosition; i < m_records.count(); ++i)
+	{
+		records.append(m_records.at(i));
+	}
+
+	for (int i = 0; i < m_recordsPosition; ++i)
+	{
+		records.append(m_records.at(i));
+	}
+
+	return records;
+}
+
+QList<QUrl> NetworkAccessManager::getPageResources() const
+{
+	return m_pageResources;
+}
+
+QList<NetworkAccessManager*> NetworkAccessManager::getManagers()
+{
+	return m_managers;
+}
+
+QVariantHash NetworkAccessManager::getStatistics()
+{
+	QVariantHash statistics;
+	statistics[QLatin1String("http1Requests")] = m_http1Requests;
+	statistics[QLatin1String("spdyRequests")] = m_spdyRequests;
+	statistics[QLatin1String("http2Requests")] = m_http2Requests;
+	statistics[QLatin1String("secureConnections")] = m_secureConnections;
+	statistics[QLatin1String("reusedSecureConnections")] = m_reusedSecureConnections;
+
+	return statistics;
+}
+
+int NetworkAccessManager::getRequestPriority(int type) const
+{
+	if (m_requestClass != PageRequestClass)
+	{
+		return (6 + m_requestClass);
+	}
+
+	int priority = 2;
+
+	if (type == DocumentRequest)
+	{
+		priority = 0;
+	}
+	else if (type == StyleSheetRequest || type == ScriptRequest)
+	{
+		priority = 1;
+	}
+
+	if (m_widget && m_widget != m_activeWidget)
+	{
+		priority += (m_widget->isVisible() ? 1 : 4);
+	}
+
+	return priority;
+}
+
+NetworkAccessManager::RequestType NetworkAccessManager::getRequestType(const QNetworkRequest &request)
+{
+	const QByteArray accept = request.rawHeader(QByteArray("Accept"));
+	const QString path = request.url().path().toLower();
+
+	if (accept.startsWith("text/css") || path.endsWith(QLatin1String(".css")))
+	{
+		return StyleSheetRequest;
+	}
+
+	if (path.endsWith(QLatin1String(".js")) || accept.contains("javascript"))
+	{
+		return ScriptRequest;
+	}
+
+	if (accept.startsWith("image/") || path.endsWith(QLatin1String(".png")) || path.endsWith(QLatin1String(".jpg")) || path.endsWith(QLatin1String(".jpeg")) || path.endsWith(QLatin1String(".gif")) || path.endsWith(QLatin1String(".webp")) || path.endsWith(QLatin1String(".svg")) || path.endsWith(QLatin1String(".ico")))
+	{
+		return ImageRequest;
+	}
+
+	if (accept.startsWith("text/html") || accept.startsWith("application/xhtml+xml"))
+	{
+		return DocumentRequest;
+	}
+
+	return OtherRequest;
 }
 
 QNetworkCookieJar* NetworkAccessManager::getCookieJar(bool privateCookieJar)
@@ -20,15 +20,69 @@
 #ifndef OTTER_NETWORKACCESSMANAGER_H
 #define OTTER_NETWORKACCESSMANAGER_H
 
+#include <QtCore/QDateTime>
+#include <QtCore/QMap>
+#include <QtCore/QPair>
+#include <QtCore/QPointer>
+#include <QtCore/QVector>
 #include <QtNetwork/QNetworkAccessManager>
 #include <QtNetwork/QNetworkDiskCache>
+#include <QtNetwork/QSslError>
 
 namespace Otter
 {
 
 class ContentsWidget;
 class CookieJar;
+class NetworkAccessManager;
 class NetworkCache;
+class ScheduledNetworkReply;
+
+struct NetworkRequestRecord
+{
+	QUrl url;
+	QByteArray method;
+	QByteArray protocol;
+	QString mimeType;
+	QDateTime startTime;
+	quint64 identifier;
+	qint64 encryptedTime;
+	qint64 headersTime;
+	qint64 firstByteTime;
+	qint64 finishTime;
+	qint64 bytesReceived;
+	int type;
+	int status;
+	bool isConnectionReused;
+	bool isFromCache;
+
+	NetworkRequestRecord() : identifier(0), encryptedTime(-1), headersTime(-1), firstByteTime(-1), finishTime(-1), bytesReceived(0), type(0), status(0), isConnectionReused(false), isFromCache(false) {}
+};
+
+class NetworkReplyStatistics : public QObject
+{
+	Q_OBJECT
+
+public:
+	NetworkReplyStatistics(QNetworkReply *reply, int generation, NetworkAccessManager *parent);
+
+	QNetworkReply *reply;
+	qint64 bytesReceived;
+	quint64 recordIdentifier;
+	int recordIndex;
+	int generation;
+	bool hasBytesTotal;
+	bool isEncrypted;
+
+protected slots:
+	void replyDownloadProgress(qint64 received, qint64 total);
+	void replyMetaDataChanged();
+	void replyEncrypted();
+	void replyFinished();
+
+private:
+	NetworkAccessManager *m_manager;
+};
 
 class NetworkAccessManager : public QNetworkAccessManager
 {
@@ -37,6 +91,7 @@ class NetworkAccessManager : public QNetworkAccessManager
 
 public:
 	explicit NetworkAccessManager(bool privateWindow = false, bool simpleMode = false, ContentsWidget *widget = NULL);
+	~NetworkAccessManager();
 
 	enum DoNotTrackPolicy
 	{
@@ -45,46 +100,136 @@ public:
 		DoNotAllowToTrackPolicy = 2
 	};
 
+	enum RequestClass
+	{
+		PageRequestClass = 0,
+		TransferRequestClass = 1,
+		SnapshotRequestClass = 2,
+		PrefetchRequestClass = 3
+	};
+
+	enum RequestType
+	{
+		OtherRequest = 0,
+		DocumentRequest = 1,
+		StyleSheetRequest = 2,
+		ScriptRequest = 3,
+		ImageRequest = 4
+	};
+
 	void resetStatistics();
+	void setStatusUpdatesEnabled(bool enabled);
+	void setMainFrame(QObject *frame);
+	void setRequestClass(RequestClass requestClass);
+	void updateReplyProgress(NetworkReplyStatistics *statistics, qint64 bytesReceived, qint64 bytesTotal);
+	void updateReplyHeaders(NetworkReplyStatistics *statistics);
+	void updateReplyEncrypted(NetworkReplyStatistics *statistics);
+	void updateReplyFinished(NetworkReplyStatistics *statistics);
+	void clearRecords();
+	void clearPageResources();
+	ContentsWidget* getWidget() const;
+	QList<NetworkRequestRecord> getRecords() const;
+	QList<QUrl> getPageResources() const;
+	static QList<NetworkAccessManager*> getManagers();
+	static QVariantHash getStatistics();
 	static void clearCookies(int period = 0);
 	static void clearCache(int period = 0);
+	static QNetworkAccessManager* getTransport(bool privateTransport = false);
 	static QNetworkCookieJar* getCookieJar(bool privateCookieJar = false);
 	static NetworkCache* getCache();
+	static ContentsWidget* getActiveWidget();
+	static void setActiveWidget(ContentsWidget *widget);
+	static void unscheduleRequest(ScheduledNetworkReply *reply);
 
 protected:
 	void timerEvent(QTimerEvent *event);
 	void updateStatus();
+	void showPrompt(QWidget *dialog, const QString &key);
+	void closePrompt(QWidget *dialog);
+	void startRequest(ScheduledNetworkReply *reply);
+	void trackRequest(QNetworkReply *reply);
+	void releaseRequest(QObject *reply);
+	QNetworkReply* sendRequest(Operation operation, const QNetworkRequest &request, QIODevice *outgoingData);
+	NetworkRequestRecord* getRecord(NetworkReplyStatistics *statistics);
 	QNetworkReply *createRequest(Operation operation, const QNetworkRequest &request, QIODevice *outgoingData);
+	int getRequestPriority(int type) const;
+	static void resolvePrompt(const QString &key, bool accepted);
+	static void scheduleRequest(ScheduledNetworkReply *reply);
+	static void dispatchRequests();
+	static RequestType getRequestType(const QNetworkRequest &request);
 
 protected slots:
 	void optionChanged(const QString &option, const QVariant &value);
-	void downloadProgress(qint64 bytesReceived, qint64 bytesTotal);
 	void requestFinished(QNetworkReply *reply);
+	void transportReplyFinished();
+	void transportReplyDestroyed(QObject *reply);
 	void handleAuthenticationRequired(QNetworkReply *reply, QAuthenticator *authenticator);
 	void handleSslErrors(QNetworkReply *reply, const QList<QSslError> &errors);
+	void authenticationDialogFinished(int result);
+	void sslErrorsDialogFinished(int result);
+	void promptDestroyed(QObject *dialog);
 
 private:
 	ContentsWidget *m_widget;
 	QNetworkReply *m_mainReply;
-	QHash<QNetworkReply*, QPair<qint64, bool> > m_replies;
+	QPointer<QObject> m_mainFrame;
+	QUrl m_baseUrl;
+	QSet<QNetworkReply*> m_transportReplies;
+	QSet<QNetworkReply*> m_authenticatedReplies;
+	QSet<QString> m_waitingPrompts;
+	QSet<QString> m_waitingNavigations;
+	QMultiHash<QString, QUrl> m_waitingUrls;
+	QHash<QObject*, QString> m_prompts;
+	QHash<QObject*, QString> m_runningReplies;
+	QList<QUrl> m_pageResources;
+	QVector<NetworkRequestRecord> m_records;
+	quint64 m_recordsCounter;
 	qint64 m_speed;
 	qint64 m_bytesReceivedDifference;
 	qint64 m_bytesReceived;
 	qint64 m_bytesTotal;
 	DoNotTrackPolicy m_doNotTrackPolicy;
+	RequestClass m_requestClass;
 	int m_finishedRequests;
 	int m_startedRequests;
+	int m_activeReplies;
+	int m_generation;
+	int m_recordsLimit;
+	int m_recordsPosition;
 	int m_updateTimer;
+	bool m_areStatusUpdatesEnabled;
+	bool m_isPrivate;
 	bool m_simpleMode;
 
+	static QList<NetworkAccessManager*> m_managers;
+	static QList<NetworkAccessManager*> m_simpleManagers;
+	static QNetworkAccessManager *m_transport;
+	static QNetworkAccessManager *m_privateTransport;
 	static CookieJar *m_cookieJar;
 	static QNetworkCookieJar *m_privateCookieJar;
 	static NetworkCache *m_cache;
+	static QHash<QString, QPair<QString, QString> > m_credentials;
+	static QHash<QString, QList<QSslError> > m_sslExceptions;
+	static QHash<QString, QList<QSslError> > m_pendingSslErrors;
+	static QSet<QString> m_pendingPrompts;
+	static QMap<int, QList<ScheduledNetworkReply*> > m_scheduledReplies;
+	static QHash<QString, int> m_hostRequests;
+	static ContentsWidget *m_activeWidget;
+	static int m_runningRequests;
+	static int m_requestsLimit;
+	static int m_hostRequestsLimit;
+	static int m_http1Requests;
+	static int m_spdyRequests;
+	static int m_http2Requests;
+	static int m_secureConnections;
+	static int m_reusedSecureConnections;
 
 signals:
 	void messageChanged(const QString &message = QString());
 	void documentLoadProgressChanged(int progress);
 	void statusChanged(int finishedRequests, int startedReuests, qint64 bytesReceived, qint64 bytesTotal, qint64 speed);
+	void recordsChanged();
+	void retryRequired(const QUrl &url);
 };
 
 }
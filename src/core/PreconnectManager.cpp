@@ -0,0 +1,261 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2013 - 2014 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "PreconnectManager.h"
+#include "HistoryManager.h"
+#include "NetworkAccessManager.h"
+#include "SettingsManager.h"
+
+#include <QtCore/QDateTime>
+#include <QtNetwork/QSslSocket>
+
+namespace Otter
+{
+
+PreconnectManager* PreconnectManager::m_instance = NULL;
+QHash<QString, int> PreconnectManager::m_hosts;
+QSet<QString> PreconnectManager::m_secureHosts;
+QHash<QString, qint64> PreconnectManager::m_connections;
+QList<qint64> PreconnectManager::m_recentConnections;
+int PreconnectManager::m_preconnects = 0;
+int PreconnectManager::m_hits = 0;
+int PreconnectManager::m_misses = 0;
+bool PreconnectManager::m_enabled = false;
+bool PreconnectManager::m_hostsLoaded = false;
+
+const qint64 connectionLifetime = 10000;
+const int connectionsPerSecond = 4;
+
+PreconnectManager::PreconnectManager(QObject *parent) : QObject(parent)
+{
+	m_enabled = SettingsManager::getValue(QLatin1String("Network/EnablePreconnect")).toBool();
+
+	connect(SettingsManager::getInstance(), SIGNAL(valueChanged(QString,QVariant)), this, SLOT(optionChanged(QString,QVariant)));
+	connect(HistoryManager::getInstance(), SIGNAL(entryAdded(qint64)), this, SLOT(historyEntryAdded(qint64)));
+	connect(HistoryManager::getInstance(), SIGNAL(cleared()), this, SLOT(historyCleared()));
+}
+
+void PreconnectManager::createInstance(QObject *parent)
+{
+	m_instance = new PreconnectManager(parent);
+}
+
+void PreconnectManager::optionChanged(const QString &option, const QVariant &value)
+{
+	if (option == QLatin1String("Network/EnablePreconnect"))
+	{
+		m_enabled = value.toBool();
+	}
+}
+
+void PreconnectManager::historyEntryAdded(qint64 entry)
+{
+	if (!m_hostsLoaded)
+	{
+		return;
+	}
+
+	const QUrl url = HistoryManager::getEntry(entry).url;
+
+	if (!url.host().isEmpty())
+	{
+		++m_hosts[url.host()];
+
+		if (url.scheme() == QLatin1String("https"))
+		{
+			m_secureHosts.insert(url.host());
+		}
+	}
+}
+
+void PreconnectManager::historyCleared()
+{
+	m_hosts.clear();
+	m_secureHosts.clear();
+	m_hostsLoaded = false;
+}
+
+void PreconnectManager::loadHosts()
+{
+	m_hosts = HistoryManager::getHostVisits();
+	m_secureHosts = HistoryManager::getSecureHosts();
+	m_hostsLoaded = true;
+}
+
+void PreconnectManager::preconnect(const QUrl &url, bool privateWindow)
+{
+	if (!m_enabled || url.host().isEmpty() || (url.scheme() != QLatin1String("http") && url.scheme() != QLatin1String("https")))
+	{
+		return;
+	}
+
+	const QString key = url.scheme() + QLatin1String("://") + url.host();
+	const qint64 currentTime = QDateTime::currentMSecsSinceEpoch();
+
+	if (m_connections.contains(key) && (currentTime - m_connections[key]) < connectionLifetime)
+	{
+		return;
+	}
+
+	while (!m_recentConnections.isEmpty() && (currentTime - m_recentConnections.first()) > 1000)
+	{
+		m_recentConnections.removeFirst();
+	}
+
+	if (m_recentConnections.count() >= connectionsPerSecond)
+	{
+		return;
+	}
+
+	if (m_connections.count() > 256)
+	{
+		QHash<QString, qint64>::iterator iterator = m_connections.begin();
+
+		while (iterator != m_connections.end())
+		{
+			if ((currentTime - iterator.value()) >= connectionLifetime)
+			{
+				iterator = m_connections.erase(iterator);
+			}
+			else
+			{
+				++iterator;
+			}
+		}
+	}
+
+	m_recentConnections.append(currentTime);
+	m_connections[key] = currentTime;
+
+	++m_preconnects;
+
+#if QT_VERSION >= 0x050200
+	if (url.scheme() == QLatin1String("https"))
+	{
+		if (QSslSocket::supportsSsl())
+		{
+			NetworkAccessManager::getTransport(privateWindow)->connectToHostEncrypted(url.host(), url.port(443));
+		}
+	}
+	else
+	{
+		NetworkAccessManager::getTransport(privateWindow)->connectToHost(url.host(), url.port(80));
+	}
+#else
+	Q_UNUSED(privateWindow)
+#endif
+}
+
+void PreconnectManager::predict(const QString &text, bool privateWindow)
+{
+	if (!m_enabled || text.length() < 3 || text.contains(QLatin1Char(' ')))
+	{
+		return;
+	}
+
+	if (!m_hostsLoaded)
+	{
+		loadHosts();
+	}
+
+	QString prefix = text.toLower();
+	QString scheme;
+
+	if (prefix.startsWith(QLatin1String("https://")))
+	{
+		scheme = QLatin1String("https");
+		prefix = prefix.mid(8);
+	}
+	else if (prefix.startsWith(QLatin1String("http://")))
+	{
+		scheme = QLatin1String("http");
+		prefix = prefix.mid(7);
+	}
+
+	prefix = prefix.section(QLatin1Char('/'), 0, 0);
+
+	if (prefix.isEmpty())
+	{
+		return;
+	}
+
+	QString bestHost;
+	int bestScore = 0;
+	QHash<QString, int>::const_iterator iterator;
+
+	for (iterator = m_hosts.constBegin(); iterator != m_hosts.constEnd(); ++iterator)
+	{
+		if (iterator.value() > bestScore && (iterator.key().startsWith(prefix) || iterator.key().startsWith(QLatin1String("www.") + prefix)))
+		{
+			bestHost = iterator.key();
+			bestScore = iterator.value();
+		}
+	}
+
+	if (bestScore > 1)
+	{
+		if (scheme.isEmpty())
+		{
+			scheme = (m_secureHosts.contains(bestHost) ? QLatin1String("https") : QLatin1String("http"));
+		}
+
+		QUrl url;
+		url.setScheme(scheme);
+		url.setHost(bestHost);
+
+		preconnect(url, privateWindow);
+	}
+}
+
+void PreconnectManager::recordNavigation(const QUrl &url)
+{
+	if (!m_enabled || url.host().isEmpty())
+	{
+		return;
+	}
+
+	const QString key = url.scheme() + QLatin1String("://") + url.host();
+
+	if (m_connections.contains(key) && (QDateTime::currentMSecsSinceEpoch() - m_connections[key]) < connectionLifetime)
+	{
+		++m_hits;
+	}
+	else
+	{
+		++m_misses;
+	}
+}
+
+PreconnectManager* PreconnectManager::getInstance()
+{
+	return m_instance;
+}
+
+QVariantHash PreconnectManager::getStatistics()
+{
+	QVariantHash statistics;
+	statistics[QLatin1String("preconnects")] = m_preconnects;
+	statistics[QLatin1String("hits")] = m_hits;
+	statistics[QLatin1String("misses")] = m_misses;
+	statistics[QLatin1String("hosts")] = m_hosts.count();
+
+	return statistics;
+}
+
+}
@@ -0,0 +1,69 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2013 - 2014 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_PRECONNECTMANAGER_H
+#define OTTER_PRECONNECTMANAGER_H
+
+#include <QtCore/QHash>
+#include <QtCore/QObject>
+#include <QtCore/QSet>
+#include <QtCore/QUrl>
+#include <QtCore/QVariant>
+
+namespace Otter
+{
+
+class PreconnectManager : public QObject
+{
+	Q_OBJECT
+
+public:
+	static void createInstance(QObject *parent = NULL);
+	static void preconnect(const QUrl &url, bool privateWindow = false);
+	static void predict(const QString &text, bool privateWindow = false);
+	static void recordNavigation(const QUrl &url);
+	static PreconnectManager* getInstance();
+	static QVariantHash getStatistics();
+
+protected:
+	static void loadHosts();
+
+protected slots:
+	void optionChanged(const QString &option, const QVariant &value);
+	void historyEntryAdded(qint64 entry);
+	void historyCleared();
+
+private:
+	explicit PreconnectManager(QObject *parent = NULL);
+
+	static PreconnectManager *m_instance;
+	static QHash<QString, int> m_hosts;
+	static QSet<QString> m_secureHosts;
+	static QHash<QString, qint64> m_connections;
+	static QList<qint64> m_recentConnections;
+	static int m_preconnects;
+	static int m_hits;
+	static int m_misses;
+	static bool m_enabled;
+	static bool m_hostsLoaded;
+};
+
+}
+
+#endif
@@ -0,0 +1,363 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2013 - 2014 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "PrefetchManager.h"
+#include "HistoryManager.h"
+#include "NetworkAccessManager.h"
+#include "SettingsManager.h"
+#include "../ui/ContentsWidget.h"
+
+#include <QtCore/QDateTime>
+#include <QtCore/QTimerEvent>
+#include <QtNetwork/QNetworkConfiguration>
+
+namespace Otter
+{
+
+PrefetchManager* PrefetchManager::m_instance = NULL;
+NetworkAccessManager* PrefetchManager::m_networkAccessManager = NULL;
+QNetworkConfigurationManager* PrefetchManager::m_configurationManager = NULL;
+QList<QUrl> PrefetchManager::m_queue;
+QHash<QNetworkReply*, qint64> PrefetchManager::m_replies;
+QHash<QUrl, qint64> PrefetchManager::m_prefetchedUrls;
+qint64 PrefetchManager::m_budget = 0;
+qint64 PrefetchManager::m_bytesUsed = 0;
+qint64 PrefetchManager::m_bytesTotal = 0;
+int PrefetchManager::m_timer = 0;
+int PrefetchManager::m_prefetches = 0;
+int PrefetchManager::m_hits = 0;
+int PrefetchManager::m_misses = 0;
+int PrefetchManager::m_expired = 0;
+bool PrefetchManager::m_enabled = false;
+
+const qint64 prefetchLifetime = 300000;
+const int maximumCandidates = 4;
+const int maximumReplies = 2;
+
+PrefetchManager::PrefetchManager(QObject *parent) : QObject(parent)
+{
+	m_configurationManager = new QNetworkConfigurationManager(this);
+	m_enabled = SettingsManager::getValue(QLatin1String("Network/EnablePrefetch")).toBool();
+	m_budget = (SettingsManager::getValue(QLatin1String("Network/PrefetchBudget")).toLongLong() * 1024);
+
+	connect(SettingsManager::getInstance(), SIGNAL(valueChanged(QString,QVariant)), this, SLOT(optionChanged(QString,QVariant)));
+}
+
+void PrefetchManager::createInstance(QObject *parent)
+{
+	m_instance = new PrefetchManager(parent);
+}
+
+void PrefetchManager::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() != m_timer)
+	{
+		return;
+	}
+
+	if (m_queue.isEmpty() && m_replies.isEmpty())
+	{
+		killTimer(m_timer);
+
+		m_timer = 0;
+
+		return;
+	}
+
+	if (isPaused())
+	{
+		abortReplies(true);
+
+		return;
+	}
+
+	while (!m_queue.isEmpty() && m_replies.count() < maximumReplies)
+	{
+		if (m_bytesUsed >= m_budget)
+		{
+			m_queue.clear();
+
+			break;
+		}
+
+		QNetworkRequest request(m_queue.takeFirst());
+		request.setPriority(QNetworkRequest::LowPriority);
+		request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::PreferCache);
+		request.setRawHeader(QByteArray("Accept"), QByteArray("text/html,application/xhtml+xml,application/xml;q=0.9,*/*;q=0.8"));
+		request.setRawHeader(QByteArray("Purpose"), QByteArray("prefetch"));
+		request.setRawHeader(QByteArray("X-Moz"), QByteArray("prefetch"));
+
+		QNetworkReply *reply = getNetworkAccessManager()->get(request);
+
+		m_replies[reply] = 0;
+
+		connect(reply, SIGNAL(downloadProgress(qint64,qint64)), this, SLOT(replyProgress(qint64,qint64)));
+		connect(reply, SIGNAL(finished()), this, SLOT(replyFinished()));
+	}
+}
+
+void PrefetchManager::optionChanged(const QString &option, const QVariant &value)
+{
+	if (option == QLatin1String("Network/EnablePrefetch"))
+	{
+		m_enabled = value.toBool();
+
+		if (!m_enabled)
+		{
+			m_queue.clear();
+
+			abortReplies(false);
+		}
+	}
+	else if (option == QLatin1String("Network/PrefetchBudget"))
+	{
+		m_budget = (value.toLongLong() * 1024);
+	}
+}
+
+void PrefetchManager::replyProgress(qint64 received, qint64 total)
+{
+	QNetworkReply *reply = qobject_cast<QNetworkReply*>(sender());
+
+	if (!reply || !m_replies.contains(reply))
+	{
+		return;
+	}
+
+	m_bytesUsed += (received - m_replies[reply]);
+
+	m_replies[reply] = received;
+
+	if (m_bytesUsed > m_budget || (total > 0 && (m_bytesUsed - received + total) > m_budget))
+	{
+		reply->abort();
+	}
+}
+
+void PrefetchManager::replyFinished()
+{
+	QNetworkReply *reply = qobject_cast<QNetworkReply*>(sender());
+
+	if (!reply || !m_replies.contains(reply))
+	{
+		return;
+	}
+
+	m_bytesTotal += m_replies.take(reply);
+
+	if (reply->error() == QNetworkReply::NoError && reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() == 200)
+	{
+		m_prefetchedUrls[reply->url().adjusted(QUrl::RemoveFragment)] = QDateTime::currentMSecsSinceEpoch();
+
+		++m_prefetches;
+	}
+
+	reply->deleteLater();
+}
+
+void PrefetchManager::abortReplies(bool requeue)
+{
+	const QList<QNetworkReply*> replies = m_replies.keys();
+
+	m_replies.clear();
+
+	for (int i = 0; i < replies.count(); ++i)
+	{
+		disconnect(replies.at(i), 0, m_instance, 0);
+
+		if (requeue)
+		{
+			m_queue.prepend(replies.at(i)->url());
+		}
+
+		replies.at(i)->abort();
+		replies.at(i)->deleteLater();
+	}
+}
+
+void PrefetchManager::expireUrls()
+{
+	const qint64 currentTime = QDateTime::currentMSecsSinceEpoch();
+	QHash<QUrl, qint64>::iterator iterator = m_prefetchedUrls.begin();
+
+	while (iterator != m_prefetchedUrls.end())
+	{
+		if ((currentTime - iterator.value()) >= prefetchLifetime)
+		{
+			iterator = m_prefetchedUrls.erase(iterator);
+
+			++m_expired;
+		}
+		else
+		{
+			++iterator;
+		}
+	}
+}
+
+void PrefetchManager::prefetch(const QUrl &url, const QList<QUrl> &hints)
+{
+	if (!m_enabled || m_budget <= 0 || (url.scheme() != QLatin1String("http") && url.scheme() != QLatin1String("https")))
+	{
+		return;
+	}
+
+	m_queue.clear();
+	m_bytesUsed = 0;
+
+	abortReplies(false);
+	expireUrls();
+
+	const QUrl currentUrl = url.adjusted(QUrl::RemoveFragment);
+	const QList<QUrl> transitions = HistoryManager::getTransitions(url, maximumCandidates);
+	QList<QUrl> candidates = hints;
+
+	for (int i = 0; i < transitions.count(); ++i)
+	{
+		const QUrl transition = transitions.at(i);
+
+		if (!transition.hasQuery() && transition.scheme() == currentUrl.scheme() && transition.host() == currentUrl.host() && transition.port() == currentUrl.port())
+		{
+			candidates.append(transition);
+		}
+	}
+
+	for (int i = 0; i < candidates.count() && m_queue.count() < maximumCandidates; ++i)
+	{
+		const QUrl candidate = candidates.at(i).adjusted(QUrl::RemoveFragment);
+
+		if (candidate.isValid() && candidate != currentUrl && (candidate.scheme() == QLatin1String("http") || candidate.scheme() == QLatin1String("https")) && !m_prefetchedUrls.contains(candidate) && !m_queue.contains(candidate))
+		{
+			m_queue.append(candidate);
+		}
+	}
+
+	if (!m_queue.isEmpty() && m_timer == 0)
+	{
+		m_timer = m_instance->startTimer(500);
+	}
+}
+
+void PrefetchManager::recordNavigation(const QUrl &url, bool isFromCache)
+{
+	if (!m_enabled || (url.scheme() != QLatin1String("http") && url.scheme() != QLatin1String("https")))
+	{
+		return;
+	}
+
+	expireUrls();
+
+	const QUrl normalizedUrl = url.adjusted(QUrl::RemoveFragment);
+
+	if (m_prefetchedUrls.remove(normalizedUrl) > 0 && isFromCache)
+	{
+		++m_hits;
+	}
+	else
+	{
+		++m_misses;
+	}
+}
+
+NetworkAccessManager* PrefetchManager::getNetworkAccessManager()
+{
+	if (!m_networkAccessManager)
+	{
+		m_networkAccessManager = new NetworkAccessManager(false, true, NULL);
+		m_networkAccessManager->setRequestClass(NetworkAccessManager::PrefetchRequestClass);
+		m_networkAccessManager->setParent(m_instance);
+	}
+
+	return m_networkAccessManager;
+}
+
+PrefetchManager* PrefetchManager::getInstance()
+{
+	return m_instance;
+}
+
+QVariantHash PrefetchManager::getStatistics()
+{
+	QVariantHash statistics;
+	statistics[QLatin1String("prefetches")] = m_prefetches;
+	statistics[QLatin1String("hits")] = m_hits;
+	statistics[QLatin1String("misses")] = m_misses;
+	statistics[QLatin1String("expired")] = m_expired;
+	statistics[QLatin1String("pending")] = (m_queue.count() + m_replies.count());
+	statistics[QLatin1String("bytes")] = m_bytesTotal;
+	statistics[QLatin1String("hitRate")] = (((m_hits + m_misses) > 0) ? (static_cast<double>(m_hits) / (m_hits + m_misses)) : 0.0);
+
+	return statistics;
+}
+
+bool PrefetchManager::isPaused()
+{
+	ContentsWidget *activeWidget = NetworkAccessManager::getActiveWidget();
+
+	if (activeWidget)
+	{
+		const QList<NetworkAccessManager*> managers = NetworkAccessManager::getManagers();
+
+		for (int i = 0; i < managers.count(); ++i)
+		{
+			if (managers.at(i)->getWidget() == activeWidget)
+			{
+				if (activeWidget->isLoading())
+				{
+					return true;
+				}
+
+				break;
+			}
+		}
+	}
+
+	if (!m_configurationManager)
+	{
+		return false;
+	}
+
+	const QNetworkConfiguration configuration = m_configurationManager->defaultConfiguration();
+
+#if QT_VERSION >= 0x050200
+	switch (configuration.bearerTypeFamily())
+	{
+		case QNetworkConfiguration::Bearer2G:
+		case QNetworkConfiguration::Bearer3G:
+		case QNetworkConfiguration::Bearer4G:
+			return true;
+		default:
+			return false;
+	}
+#else
+	switch (configuration.bearerType())
+	{
+		case QNetworkConfiguration::Bearer2G:
+		case QNetworkConfiguration::BearerCDMA2000:
+		case QNetworkConfiguration::BearerWCDMA:
+		case QNetworkConfiguration::BearerHSPA:
+		case QNetworkConfiguration::BearerWiMAX:
+			return true;
+		default:
+			return false;
+	}
+#endif
+}
+
+}
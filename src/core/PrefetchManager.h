@@ -0,0 +1,80 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2013 - 2014 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_PREFETCHMANAGER_H
+#define OTTER_PREFETCHMANAGER_H
+
+#include <QtCore/QHash>
+#include <QtCore/QObject>
+#include <QtCore/QUrl>
+#include <QtCore/QVariant>
+#include <QtNetwork/QNetworkConfigurationManager>
+#include <QtNetwork/QNetworkReply>
+
+namespace Otter
+{
+
+class NetworkAccessManager;
+
+class PrefetchManager : public QObject
+{
+	Q_OBJECT
+
+public:
+	static void createInstance(QObject *parent = NULL);
+	static void prefetch(const QUrl &url, const QList<QUrl> &hints);
+	static void recordNavigation(const QUrl &url, bool isFromCache);
+	static PrefetchManager* getInstance();
+	static QVariantHash getStatistics();
+	static bool isPaused();
+
+protected:
+	void timerEvent(QTimerEvent *event);
+	static void abortReplies(bool requeue);
+	static void expireUrls();
+	static NetworkAccessManager* getNetworkAccessManager();
+
+protected slots:
+	void optionChanged(const QString &option, const QVariant &value);
+	void replyProgress(qint64 received, qint64 total);
+	void replyFinished();
+
+private:
+	explicit PrefetchManager(QObject *parent = NULL);
+
+	static PrefetchManager *m_instance;
+	static NetworkAccessManager *m_networkAccessManager;
+	static QNetworkConfigurationManager *m_configurationManager;
+	static QList<QUrl> m_queue;
+	static QHash<QNetworkReply*, qint64> m_replies;
+	static QHash<QUrl, qint64> m_prefetchedUrls;
+	static qint64 m_budget;
+	static qint64 m_bytesUsed;
+	static qint64 m_bytesTotal;
+	static int m_timer;
+	static int m_prefetches;
+	static int m_hits;
+	static int m_misses;
+	static int m_expired;
+	static bool m_enabled;
+};
+
+}
+
+#endif
@@ -0,0 +1,135 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2013 - 2014 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "ResourceNetworkReply.h"
+#include "Utils.h"
+
+#include <QtCore/QBuffer>
+#include <QtCore/QTimer>
+#include <QtCore/QUrlQuery>
+#include <QtGui/QIcon>
+
+namespace Otter
+{
+
+QCache<QString, QByteArray> ResourceNetworkReply::m_resources(1048576);
+
+ResourceNetworkReply::ResourceNetworkReply(QObject *parent, const QNetworkRequest &request) : QNetworkReply(parent),
+	m_offset(0)
+{
+	setRequest(request);
+	setUrl(request.url());
+
+	open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+
+	const QString path = request.url().path();
+
+	if (path.startsWith(QLatin1String("icon/")))
+	{
+		const int size = QUrlQuery(request.url()).queryItemValue(QLatin1String("size")).toInt();
+
+		m_content = getIconData(path.mid(5), ((size > 0 && size <= 256) ? size : 16));
+	}
+
+	if (m_content.isEmpty())
+	{
+		setError(ContentNotFoundError, tr("Resource not found"));
+		setAttribute(QNetworkRequest::HttpStatusCodeAttribute, 404);
+
+		QTimer::singleShot(0, this, SIGNAL(finished()));
+
+		return;
+	}
+
+	setHeader(QNetworkRequest::ContentTypeHeader, QVariant("image/png"));
+	setHeader(QNetworkRequest::ContentLengthHeader, QVariant(m_content.size()));
+	setRawHeader(QByteArray("Cache-Control"), QByteArray("max-age=31536000"));
+	setAttribute(QNetworkRequest::HttpStatusCodeAttribute, 200);
+
+	QTimer::singleShot(0, this, SIGNAL(readyRead()));
+	QTimer::singleShot(0, this, SIGNAL(finished()));
+}
+
+void ResourceNetworkReply::abort()
+{
+}
+
+qint64 ResourceNetworkReply::bytesAvailable() const
+{
+	return (m_content.size() - m_offset);
+}
+
+qint64 ResourceNetworkReply::readData(char *data, qint64 maxSize)
+{
+	if (m_offset < m_content.size())
+	{
+		qint64 number = qMin(maxSize, m_content.size() - m_offset);
+
+		memcpy(data, (m_content.constData() + m_offset), number);
+
+		m_offset += number;
+
+		return number;
+	}
+
+	return -1;
+}
+
+QUrl ResourceNetworkReply::getIconUrl(const QString &name)
+{
+	QUrl url;
+	url.setScheme(QLatin1String("otter"));
+	url.setPath(QLatin1String("icon/") + name);
+
+	return url;
+}
+
+QByteArray ResourceNetworkReply::getIconData(const QString &name, int size)
+{
+	if (name.isEmpty())
+	{
+		return QByteArray();
+	}
+
+	const QString key = QString("icon/%1/%2").arg(name).arg(size);
+
+	if (!m_resources.contains(key))
+	{
+		QByteArray *byteArray = new QByteArray();
+		QBuffer buffer(byteArray);
+		buffer.open(QIODevice::WriteOnly);
+
+		QIcon::fromTheme(name, Utils::getIcon((name == QLatin1String("inode-directory")) ? QLatin1String("inode-directory") : QLatin1String("unknown"))).pixmap(size, size).save(&buffer, "PNG");
+
+		const QByteArray data = *byteArray;
+
+		m_resources.insert(key, byteArray, qMax(1, byteArray->size()));
+
+		return data;
+	}
+
+	return *m_resources.object(key);
+}
+
+bool ResourceNetworkReply::isSequential() const
+{
+	return true;
+}
+
+}
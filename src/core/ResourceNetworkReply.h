@@ -0,0 +1,56 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2013 - 2014 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_RESOURCENETWORKREPLY_H
+#define OTTER_RESOURCENETWORKREPLY_H
+
+#include <QtCore/QCache>
+#include <QtNetwork/QNetworkReply>
+
+namespace Otter
+{
+
+class ResourceNetworkReply : public QNetworkReply
+{
+	Q_OBJECT
+
+public:
+	ResourceNetworkReply(QObject *parent, const QNetworkRequest &request);
+
+	qint64 bytesAvailable() const;
+	qint64 readData(char *data, qint64 maxSize);
+	bool isSequential() const;
+	static QUrl getIconUrl(const QString &name);
+
+public slots:
+	void abort();
+
+protected:
+	static QByteArray getIconData(const QString &name, int size);
+
+private:
+	QByteArray m_content;
+	qint64 m_offset;
+
+	static QCache<QString, QByteArray> m_resources;
+};
+
+}
+
+#endif
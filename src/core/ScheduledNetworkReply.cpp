@@ -0,0 +1,241 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2013 - 2014 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "ScheduledNetworkReply.h"
+#include "NetworkAccessManager.h"
+
+#include <QtNetwork/QSslConfiguration>
+
+namespace Otter
+{
+
+ScheduledNetworkReply::ScheduledNetworkReply(NetworkAccessManager *parent, const QNetworkRequest &request, QNetworkAccessManager::Operation operation, int type) : QNetworkReply(parent),
+	m_manager(parent),
+	m_type(type),
+	m_priority(0),
+	m_ignoreSslErrors(false)
+{
+	setRequest(request);
+	setUrl(request.url());
+	setOperation(operation);
+
+	open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+}
+
+ScheduledNetworkReply::~ScheduledNetworkReply()
+{
+	if (m_reply)
+	{
+		disconnect(m_reply, NULL, this, NULL);
+
+		if (!m_reply->isFinished())
+		{
+			m_reply->abort();
+		}
+
+		m_reply->deleteLater();
+	}
+	else
+	{
+		NetworkAccessManager::unscheduleRequest(this);
+	}
+}
+
+void ScheduledNetworkReply::abort()
+{
+	if (m_reply)
+	{
+		m_reply->abort();
+
+		return;
+	}
+
+	if (isFinished())
+	{
+		return;
+	}
+
+	NetworkAccessManager::unscheduleRequest(this);
+
+	setError(OperationCanceledError, tr("Operation canceled"));
+	setFinished(true);
+
+	emit error(OperationCanceledError);
+	emit finished();
+}
+
+void ScheduledNetworkReply::ignoreSslErrors()
+{
+	m_ignoreSslErrors = true;
+
+	if (m_reply)
+	{
+		m_reply->ignoreSslErrors();
+	}
+}
+
+void ScheduledNetworkReply::ignoreSslErrorsImplementation(const QList<QSslError> &errors)
+{
+	m_ignoredSslErrors = errors;
+
+	if (m_reply)
+	{
+		m_reply->ignoreSslErrors(errors);
+	}
+}
+
+void ScheduledNetworkReply::sslConfigurationImplementation(QSslConfiguration &configuration) const
+{
+	if (m_reply)
+	{
+		configuration = m_reply->sslConfiguration();
+	}
+}
+
+void ScheduledNetworkReply::copyMetaData()
+{
+	const QList<QNetworkReply::RawHeaderPair> headers = m_reply->rawHeaderPairs();
+
+	for (int i = 0; i < headers.count(); ++i)
+	{
+		setRawHeader(headers.at(i).first, headers.at(i).second);
+	}
+
+	for (int i = QNetworkRequest::HttpStatusCodeAttribute; i < QNetworkRequest::User; ++i)
+	{
+		const QNetworkRequest::Attribute attribute = static_cast<QNetworkRequest::Attribute>(i);
+		const QVariant value = m_reply->attribute(attribute);
+
+		if (value.isValid())
+		{
+			setAttribute(attribute, value);
+		}
+	}
+
+	setUrl(m_reply->url());
+}
+
+void ScheduledNetworkReply::replyMetaDataChanged()
+{
+	copyMetaData();
+
+	emit metaDataChanged();
+}
+
+void ScheduledNetworkReply::replyError(QNetworkReply::NetworkError error)
+{
+	setError(error, m_reply->errorString());
+
+	emit this->error(error);
+}
+
+void ScheduledNetworkReply::replyFinished()
+{
+	copyMetaData();
+	setFinished(true);
+
+	emit finished();
+}
+
+void ScheduledNetworkReply::setReply(QNetworkReply *reply)
+{
+	m_reply = reply;
+
+	if (QNetworkReply::readBufferSize() > 0)
+	{
+		reply->setReadBufferSize(QNetworkReply::readBufferSize());
+	}
+
+	if (m_ignoreSslErrors)
+	{
+		reply->ignoreSslErrors();
+	}
+	else if (!m_ignoredSslErrors.isEmpty())
+	{
+		reply->ignoreSslErrors(m_ignoredSslErrors);
+	}
+
+	connect(reply, SIGNAL(metaDataChanged()), this, SLOT(replyMetaDataChanged()));
+	connect(reply, SIGNAL(readyRead()), this, SIGNAL(readyRead()));
+	connect(reply, SIGNAL(downloadProgress(qint64,qint64)), this, SIGNAL(downloadProgress(qint64,qint64)));
+	connect(reply, SIGNAL(uploadProgress(qint64,qint64)), this, SIGNAL(uploadProgress(qint64,qint64)));
+	connect(reply, SIGNAL(error(QNetworkReply::NetworkError)), this, SLOT(replyError(QNetworkReply::NetworkError)));
+	connect(reply, SIGNAL(sslErrors(QList<QSslError>)), this, SIGNAL(sslErrors(QList<QSslError>)));
+#if QT_VERSION >= 0x050100
+	connect(reply, SIGNAL(encrypted()), this, SIGNAL(encrypted()));
+#endif
+	connect(reply, SIGNAL(finished()), this, SLOT(replyFinished()));
+}
+
+void ScheduledNetworkReply::setReadBufferSize(qint64 size)
+{
+	QNetworkReply::setReadBufferSize(size);
+
+	if (m_reply)
+	{
+		m_reply->setReadBufferSize(size);
+	}
+}
+
+void ScheduledNetworkReply::setPriority(int priority)
+{
+	m_priority = priority;
+}
+
+NetworkAccessManager* ScheduledNetworkReply::getManager() const
+{
+	return m_manager;
+}
+
+QString ScheduledNetworkReply::getHost() const
+{
+	return request().url().host();
+}
+
+qint64 ScheduledNetworkReply::readData(char *data, qint64 maxSize)
+{
+	if (!m_reply)
+	{
+		return (isFinished() ? -1 : 0);
+	}
+
+	return m_reply->read(data, maxSize);
+}
+
+qint64 ScheduledNetworkReply::bytesAvailable() const
+{
+	return ((m_reply ? m_reply->bytesAvailable() : 0) + QNetworkReply::bytesAvailable());
+}
+
+int ScheduledNetworkReply::getType() const
+{
+	return m_type;
+}
+
+int ScheduledNetworkReply::getPriority() const
+{
+	return m_priority;
+}
+
+bool ScheduledNetworkReply::isSequential() const
+{
+	return true;
+}
+
+}
@@ -0,0 +1,75 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2013 - 2014 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_SCHEDULEDNETWORKREPLY_H
+#define OTTER_SCHEDULEDNETWORKREPLY_H
+
+#include <QtCore/QPointer>
+#include <QtNetwork/QNetworkReply>
+
+namespace Otter
+{
+
+class NetworkAccessManager;
+
+class ScheduledNetworkReply : public QNetworkReply
+{
+	Q_OBJECT
+
+public:
+	ScheduledNetworkReply(NetworkAccessManager *parent, const QNetworkRequest &request, QNetworkAccessManager::Operation operation, int type);
+	~ScheduledNetworkReply();
+
+	void setReply(QNetworkReply *reply);
+	void setReadBufferSize(qint64 size);
+	void setPriority(int priority);
+	NetworkAccessManager* getManager() const;
+	QString getHost() const;
+	qint64 bytesAvailable() const;
+	int getType() const;
+	int getPriority() const;
+	bool isSequential() const;
+
+public slots:
+	void abort();
+	void ignoreSslErrors();
+
+protected:
+	void copyMetaData();
+	void ignoreSslErrorsImplementation(const QList<QSslError> &errors);
+	void sslConfigurationImplementation(QSslConfiguration &configuration) const;
+	qint64 readData(char *data, qint64 maxSize);
+
+protected slots:
+	void replyMetaDataChanged();
+	void replyError(QNetworkReply::NetworkError error);
+	void replyFinished();
+
+private:
+	NetworkAccessManager *m_manager;
+	QPointer<QNetworkReply> m_reply;
+	QList<QSslError> m_ignoredSslErrors;
+	int m_type;
+	int m_priority;
+	bool m_ignoreSslErrors;
+};
+
+}
+
+#endif
@@ -21,85 +21,250 @@
 #include "NetworkAccessManager.h"
 #include "SearchesManager.h"
 
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDateTime>
 #include <QtCore/QJsonArray>
 #include <QtCore/QJsonDocument>
 #include <QtCore/QTimer>
+#include <QtCore/QTimerEvent>
 #include <QtNetwork/QNetworkReply>
+#include <QtNetwork/QSslSocket>
 
 namespace Otter
 {
 
+NetworkAccessManager* SearchSuggester::m_networkAccessManager = NULL;
+QCache<QString, SearchSuggestionsCacheEntry> SearchSuggester::m_cache(500);
+int SearchSuggester::m_queries = 0;
+int SearchSuggester::m_requests = 0;
+int SearchSuggester::m_cacheHits = 0;
+
 SearchSuggester::SearchSuggester(const QString &engine, QObject *parent) : QObject(parent),
-	m_networkAccessManager(new NetworkAccessManager(true, true, NULL)),
 	m_currentReply(NULL),
 	m_model(NULL),
-	m_engine(engine)
+	m_engine(engine),
+	m_requestTimer(0)
 {
-	connect(m_networkAccessManager, SIGNAL(finished(QNetworkReply*)), this, SLOT(replyFinished(QNetworkReply*)));
+	connect(getNetworkAccessManager(), SIGNAL(retryRequired(QUrl)), this, SLOT(retryRequest(QUrl)));
+}
+
+void SearchSuggester::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() == m_requestTimer)
+	{
+		killTimer(m_requestTimer);
+
+		m_requestTimer = 0;
+
+		sendRequest();
+	}
+}
+
+void SearchSuggester::sendRequest()
+{
+	if (m_currentReply)
+	{
+		if (m_requestedQuery == m_query)
+		{
+			return;
+		}
+
+		QNetworkReply *reply = m_currentReply;
+
+		m_currentReply = NULL;
+
+		reply->abort();
+	}
+
+	SearchInformation *engine = SearchesManager::getSearchEngine(m_engine);
+
+	if (!engine || engine->suggestionsUrl.url.isEmpty() || m_query.isEmpty())
+	{
+		return;
+	}
+
+	QNetworkRequest request;
+	QNetworkAccessManager::Operation method;
+	QByteArray body;
+
+	SearchesManager::setupQuery(m_query, engine->suggestionsUrl, &request, &method, &body);
+
+	request.setAttribute(QNetworkRequest::HttpPipeliningAllowedAttribute, true);
+	request.setPriority(QNetworkRequest::HighPriority);
+
+	m_requestedQuery = m_query;
+
+	++m_requests;
+
+	if (method == QNetworkAccessManager::PostOperation)
+	{
+		m_currentReply = getNetworkAccessManager()->post(request, body);
+	}
+	else
+	{
+		m_currentReply = getNetworkAccessManager()->get(request);
+	}
+
+	connect(m_currentReply, SIGNAL(finished()), this, SLOT(replyFinished()));
+}
+
+void SearchSuggester::retryRequest(const QUrl &url)
+{
+	SearchInformation *engine = SearchesManager::getSearchEngine(m_engine);
+
+	if (!m_currentReply && engine && !m_query.isEmpty() && QUrl(engine->suggestionsUrl.url).host() == url.host())
+	{
+		sendRequest();
+	}
+}
+
+void SearchSuggester::preconnect()
+{
+	SearchInformation *engine = SearchesManager::getSearchEngine(m_engine);
+
+	if (!engine || engine->suggestionsUrl.url.isEmpty())
+	{
+		return;
+	}
+
+#if QT_VERSION >= 0x050200
+	const QUrl url(engine->suggestionsUrl.url);
+
+	if (url.host().isEmpty() || url.host().contains(QLatin1Char('{')))
+	{
+		return;
+	}
+
+	if (url.scheme() == QLatin1String("https"))
+	{
+		if (QSslSocket::supportsSsl())
+		{
+			NetworkAccessManager::getTransport(true)->connectToHostEncrypted(url.host(), url.port(443));
+		}
+	}
+	else if (url.scheme() == QLatin1String("http"))
+	{
+		NetworkAccessManager::getTransport(true)->connectToHost(url.host(), url.port(80));
+	}
+#endif
+}
+
+void SearchSuggester::applySuggestions(const QList<SearchSuggestion> &suggestions)
+{
+	if (m_model)
+	{
+		m_model->clear();
+
+		for (int i = 0; i < suggestions.count(); ++i)
+		{
+			m_model->appendRow(new QStandardItem(suggestions.at(i).completion));
+		}
+	}
+
+	emit suggestionsChanged(suggestions);
 }
 
 void SearchSuggester::setEngine(const QString &engine)
 {
 	const QString query = m_query;
 
+	if (m_currentReply)
+	{
+		QNetworkReply *reply = m_currentReply;
+
+		m_currentReply = NULL;
+
+		reply->abort();
+	}
+
 	m_engine = engine;
 	m_query = QString();
+	m_requestedQuery = QString();
 
 	setQuery(query);
 }
 
 void SearchSuggester::setQuery(const QString &query)
 {
-	if (query != m_query)
+	if (query == m_query)
 	{
-		m_query = query;
+		return;
+	}
 
-		if (m_currentReply)
-		{
-			m_currentReply->abort();
+	m_query = query;
 
-			QTimer::singleShot(250, m_currentReply, SLOT(deleteLater()));
+	++m_queries;
 
-			m_currentReply = NULL;
-		}
+	if (m_requestTimer != 0)
+	{
+		killTimer(m_requestTimer);
 
-		SearchInformation *engine = SearchesManager::getSearchEngine(m_engine);
+		m_requestTimer = 0;
+	}
 
-		if (!engine || engine->suggestionsUrl.url.isEmpty())
-		{
-			return;
-		}
+	if (query.isEmpty())
+	{
+		applySuggestions(QList<SearchSuggestion>());
 
-		QNetworkRequest request;
-		QNetworkAccessManager::Operation method;
-		QByteArray body;
+		return;
+	}
 
-		SearchesManager::setupQuery(query, engine->suggestionsUrl, &request, &method, &body);
+	SearchSuggestionsCacheEntry *entry = getCacheEntry(m_engine, query);
 
-		if (method == QNetworkAccessManager::PostOperation)
-		{
-			m_currentReply = m_networkAccessManager->post(request, body);
-		}
-		else
+	if (entry)
+	{
+		++m_cacheHits;
+
+		applySuggestions(entry->suggestions);
+
+		return;
+	}
+
+	for (int length = (query.length() - 1); length > 0; --length)
+	{
+		entry = getCacheEntry(m_engine, query.left(length));
+
+		if (entry)
 		{
-			m_currentReply = m_networkAccessManager->get(request);
+			QList<SearchSuggestion> suggestions;
+
+			for (int i = 0; i < entry->suggestions.count(); ++i)
+			{
+				if (entry->suggestions.at(i).completion.startsWith(query, Qt::CaseInsensitive))
+				{
+					suggestions.append(entry->suggestions.at(i));
+				}
+			}
+
+			applySuggestions(suggestions);
+
+			break;
 		}
 	}
+
+	m_requestTimer = startTimer(150);
 }
 
 void SearchSuggester::replyFinished(QNetworkReply *reply)
 {
-	if (reply == m_currentReply)
+	if (!reply)
 	{
-		m_currentReply = NULL;
+		reply = qobject_cast<QNetworkReply*>(sender());
 	}
 
-	if (m_model)
+	if (!reply)
 	{
-		m_model->clear();
+		return;
 	}
 
-	if (reply->size() <= 0)
+	const bool isCurrentReply = (reply == m_currentReply);
+
+	if (isCurrentReply)
+	{
+		m_currentReply = NULL;
+	}
+
+	if (!isCurrentReply || reply->error() != QNetworkReply::NoError || reply->size() <= 0)
 	{
 		QTimer::singleShot(250, reply, SLOT(deleteLater()));
 
@@ -108,12 +273,13 @@ void SearchSuggester::replyFinished(QNetworkReply *reply)
 
 	const QJsonDocument document = QJsonDocument::fromJson(reply->readAll());
 
-	if (!document.isEmpty() && document.isArray() && document.array().count() > 1 && document.array().at(0).toString() == m_query)
+	if (!document.isEmpty() && document.isArray() && document.array().count() > 1)
 	{
 		const QJsonArray completionsArray = document.array().at(1).toArray();
 		const QJsonArray descriptionsArray = document.array().at(2).toArray();
 		const QJsonArray urlsArray = document.array().at(3).toArray();
-		QList<SearchSuggestion> suggestions;
+		SearchSuggestionsCacheEntry *entry = new SearchSuggestionsCacheEntry();
+		entry->time = QDateTime::currentMSecsSinceEpoch();
 
 		for (int i = 0; i < completionsArray.count(); ++i)
 		{
@@ -122,15 +288,15 @@ void SearchSuggester::replyFinished(QNetworkReply *reply)
 			suggestion.description = descriptionsArray.at(i).toString();
 			suggestion.url = urlsArray.at(i).toString();
 
-			if (m_model)
-			{
-				m_model->appendRow(new QStandardItem(suggestion.completion));
-			}
+			entry->suggestions.append(suggestion);
+		}
 
-			suggestions.append(suggestion);
+		if (m_requestedQuery == m_query)
+		{
+			applySuggestions(entry->suggestions);
 		}
 
-		emit suggestionsChanged(suggestions);
+		m_cache.insert((m_engine + QLatin1Char('\n') + m_requestedQuery), entry);
 	}
 
 	QTimer::singleShot(250, reply, SLOT(deleteLater()));
@@ -146,4 +312,41 @@ QStandardItemModel* SearchSuggester::getModel()
 	return m_model;
 }
 
+SearchSuggestionsCacheEntry* SearchSuggester::getCacheEntry(const QString &engine, const QString &query)
+{
+	const QString key = (engine + QLatin1Char('\n') + query);
+	SearchSuggestionsCacheEntry *entry = m_cache.object(key);
+
+	if (entry && (QDateTime::currentMSecsSinceEpoch() - entry->time) > 300000)
+	{
+		m_cache.remove(key);
+
+		return NULL;
+	}
+
+	return entry;
+}
+
+NetworkAccessManager* SearchSuggester::getNetworkAccessManager()
+{
+	if (!m_networkAccessManager)
+	{
+		m_networkAccessManager = new NetworkAccessManager(true, true, NULL);
+		m_networkAccessManager->setParent(QCoreApplication::instance());
+	}
+
+	return m_networkAccessManager;
+}
+
+QVariantHash SearchSuggester::getStatistics()
+{
+	QVariantHash statistics;
+	statistics[QLatin1String("queries")] = m_queries;
+	statistics[QLatin1String("requests")] = m_requests;
+	statistics[QLatin1String("cacheHits")] = m_cacheHits;
+	statistics[QLatin1String("requestsPerQuery")] = ((m_queries > 0) ? (static_cast<qreal>(m_requests) / m_queries) : 0.0);
+
+	return statistics;
+}
+
 }
@@ -20,7 +20,9 @@
 #ifndef OTTER_SEARCHSUGGESTER_H
 #define OTTER_SEARCHSUGGESTER_H
 
+#include <QtCore/QCache>
 #include <QtCore/QObject>
+#include <QtCore/QVariant>
 #include <QtGui/QStandardItemModel>
 #include <QtNetwork/QNetworkAccessManager>
 
@@ -34,6 +36,14 @@ struct SearchSuggestion
 	QString url;
 };
 
+struct SearchSuggestionsCacheEntry
+{
+	QList<SearchSuggestion> suggestions;
+	qint64 time;
+
+	SearchSuggestionsCacheEntry() : time(0) {}
+};
+
 class NetworkAccessManager;
 
 class SearchSuggester : public QObject
@@ -44,20 +54,37 @@ public:
 	explicit SearchSuggester(const QString &engine, QObject *parent = NULL);
 
 	QStandardItemModel* getModel();
+	static QVariantHash getStatistics();
 
 public slots:
+	void preconnect();
 	void setEngine(const QString &engine);
 	void setQuery(const QString &query);
 
+protected:
+	void timerEvent(QTimerEvent *event);
+	void sendRequest();
+	void applySuggestions(const QList<SearchSuggestion> &suggestions);
+	static SearchSuggestionsCacheEntry* getCacheEntry(const QString &engine, const QString &query);
+	static NetworkAccessManager* getNetworkAccessManager();
+
 protected slots:
-	void replyFinished(QNetworkReply *reply);
+	void replyFinished(QNetworkReply *reply = NULL);
+	void retryRequest(const QUrl &url);
 
 private:
-	NetworkAccessManager *m_networkAccessManager;
 	QNetworkReply *m_currentReply;
 	QStandardItemModel *m_model;
 	QString m_engine;
 	QString m_query;
+	QString m_requestedQuery;
+	int m_requestTimer;
+
+	static NetworkAccessManager *m_networkAccessManager;
+	static QCache<QString, SearchSuggestionsCacheEntry> m_cache;
+	static int m_queries;
+	static int m_requests;
+	static int m_cacheHits;
 
 signals:
 	void suggestionsChanged(QList<SearchSuggestion> suggestions);
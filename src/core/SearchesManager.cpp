@@ -24,6 +24,7 @@
 #include <QtCore/QBuffer>
 #include <QtCore/QDir>
 #include <QtCore/QRegularExpression>
+#include <QtCore/QTimerEvent>
 #include <QtCore/QXmlStreamReader>
 #include <QtCore/QXmlStreamWriter>
 #include <QtNetwork/QNetworkRequest>
@@ -35,9 +36,15 @@ SearchesManager* SearchesManager::m_instance = NULL;
 QStandardItemModel* SearchesManager::m_searchEnginesModel = NULL;
 QStringList SearchesManager::m_searchEnginesOrder;
 QStringList SearchesManager::m_searchShortcuts;
+QString SearchesManager::m_language;
 QHash<QString, SearchInformation*> SearchesManager::m_searchEngines;
+QHash<QString, QDateTime> SearchesManager::m_modificationTimes;
+QHash<QString, QList<SearchTemplateToken> > SearchesManager::m_templates;
+bool SearchesManager::m_isLoaded = false;
 
-SearchesManager::SearchesManager(QObject *parent) : QObject(parent)
+SearchesManager::SearchesManager(QObject *parent) : QObject(parent),
+	m_watcher(NULL),
+	m_reloadTimer(0)
 {
 }
 
@@ -46,6 +53,161 @@ void SearchesManager::createInstance(QObject *parent)
 	m_instance = new SearchesManager(parent);
 }
 
+void SearchesManager::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() == m_reloadTimer)
+	{
+		killTimer(m_reloadTimer);
+
+		m_reloadTimer = 0;
+
+		loadSearchEngines();
+	}
+}
+
+void SearchesManager::scheduleReload()
+{
+	if (m_reloadTimer == 0)
+	{
+		m_reloadTimer = startTimer(500);
+	}
+}
+
+void SearchesManager::loadSearchEngines()
+{
+	const QString path = getSearchEnginesPath();
+	const QDir directory(path);
+	const bool wasLoaded = m_isLoaded;
+
+	if (!wasLoaded)
+	{
+		m_isLoaded = true;
+
+		if (!QFile::exists(path))
+		{
+			QDir().mkpath(path);
+
+			if (directory.entryList(QDir::Files).isEmpty())
+			{
+				const QStringList definitions = QDir(QLatin1String(":/searches/")).entryList(QDir::Files);
+
+				for (int i = 0; i < definitions.count(); ++i)
+				{
+					QFile::copy(QLatin1String(":/searches/") + definitions.at(i), directory.filePath(definitions.at(i)));
+					QFile::setPermissions(directory.filePath(definitions.at(i)), (QFileDevice::ReadOwner | QFileDevice::WriteOwner | QFileDevice::ReadGroup | QFileDevice::ReadOther));
+				}
+			}
+		}
+
+		if (m_instance)
+		{
+			m_instance->m_watcher = new QFileSystemWatcher(QStringList(path), m_instance);
+
+			connect(m_instance->m_watcher, SIGNAL(directoryChanged(QString)), m_instance, SLOT(scheduleReload()));
+		}
+	}
+
+	const QFileInfoList entries = directory.entryInfoList(QDir::Files);
+	QStringList identifiers;
+	bool isModified = false;
+
+	for (int i = 0; i < entries.count(); ++i)
+	{
+		const QString identifier = entries.at(i).baseName();
+
+		identifiers.append(identifier);
+
+		if (m_searchEngines.contains(identifier) && m_modificationTimes.value(identifier) == entries.at(i).lastModified())
+		{
+			continue;
+		}
+
+		QFile file(entries.at(i).absoluteFilePath());
+
+		if (!file.open(QIODevice::ReadOnly))
+		{
+			continue;
+		}
+
+		if (m_searchEngines.contains(identifier))
+		{
+			SearchInformation *search = m_searchEngines.take(identifier);
+
+			m_searchShortcuts.removeAll(search->shortcut);
+
+			delete search;
+		}
+
+		SearchInformation *search = readSearch(&file, identifier);
+
+		file.close();
+
+		m_modificationTimes[identifier] = entries.at(i).lastModified();
+
+		if (search)
+		{
+			m_searchEngines[identifier] = search;
+
+			if (wasLoaded && !m_searchEnginesOrder.contains(identifier))
+			{
+				m_searchEnginesOrder.append(identifier);
+			}
+		}
+
+		isModified = true;
+	}
+
+	const QStringList existingIdentifiers = m_searchEngines.keys();
+
+	for (int i = 0; i < existingIdentifiers.count(); ++i)
+	{
+		if (!identifiers.contains(existingIdentifiers.at(i)))
+		{
+			SearchInformation *search = m_searchEngines.take(existingIdentifiers.at(i));
+
+			m_searchShortcuts.removeAll(search->shortcut);
+			m_searchEnginesOrder.removeAll(existingIdentifiers.at(i));
+			m_modificationTimes.remove(existingIdentifiers.at(i));
+
+			delete search;
+
+			isModified = true;
+		}
+	}
+
+	if (!wasLoaded)
+	{
+		m_searchEnginesOrder = SettingsManager::getValue(QLatin1String("Browser/SearchEnginesOrder")).toStringList();
+		m_searchEnginesOrder.removeAll(QString());
+
+		if (m_searchEnginesOrder.isEmpty())
+		{
+			QStringList engines = m_searchEngines.keys();
+			engines.sort();
+
+			m_searchEnginesOrder = engines;
+		}
+	}
+	else if (isModified && m_instance)
+	{
+		m_instance->updateSearchEnginesModel();
+
+		emit m_instance->searchEnginesModified();
+	}
+}
+
+void SearchesManager::compileSearchUrl(const SearchUrl &searchUrl)
+{
+	getTemplate(searchUrl.url);
+
+	const QList<QPair<QString, QString> > parameters = searchUrl.parameters.queryItems(QUrl::FullyDecoded);
+
+	for (int i = 0; i < parameters.count(); ++i)
+	{
+		getTemplate(parameters.at(i).second);
+	}
+}
+
 void SearchesManager::updateSearchEnginesModel()
 {
 	if (!m_searchEnginesModel)
@@ -95,38 +257,16 @@ void SearchesManager::setupQuery(const QString &query, const SearchUrl &searchUr
 		return;
 	}
 
-	QString urlString = searchUrl.url;
-	QHash<QString, QString> values;
-	values[QLatin1String("searchTerms")] = query;
-	values[QLatin1String("count")] = QString();
-	values[QLatin1String("startIndex")] = QString();
-	values[QLatin1String("startPage")] = QString();
-	values[QLatin1String("language")] = QLocale::system().name();
-	values[QLatin1String("inputEncoding")] = QLatin1String("UTF-8");
-	values[QLatin1String("outputEncoding")] = QLatin1String("UTF-8");
-
-	QHash<QString, QString>::iterator valuesIterator;
-
-	for (valuesIterator = values.begin(); valuesIterator != values.end(); ++valuesIterator)
-	{
-		urlString = urlString.replace(QString("{%1}").arg(valuesIterator.key()), valuesIterator.value());
-	}
-
 	*method = ((searchUrl.method == QLatin1String("post")) ? QNetworkAccessManager::PostOperation : QNetworkAccessManager::GetOperation);
 
-	QUrl url(urlString);
+	QUrl url(expandTemplate(searchUrl.url, query));
 	QUrlQuery getQuery(url);
 	QUrlQuery postQuery;
 	const QList<QPair<QString, QString> > parameters = searchUrl.parameters.queryItems(QUrl::FullyDecoded);
 
 	for (int i = 0; i < parameters.count(); ++i)
 	{
-		QString value = parameters.at(i).second;
-
-		for (valuesIterator = values.begin(); valuesIterator != values.end(); ++valuesIterator)
-		{
-			value = value.replace(QString("{%1}").arg(valuesIterator.key()), valuesIterator.value());
-		}
+		const QString value = expandTemplate(parameters.at(i).second, query);
 
 		if (*method == QNetworkAccessManager::GetOperation)
 		{
@@ -275,6 +415,9 @@ SearchInformation* SearchesManager::readSearch(QIODevice *device, const QString
 		return NULL;
 	}
 
+	compileSearchUrl(search->resultsUrl);
+	compileSearchUrl(search->suggestionsUrl);
+
 	return search;
 }
 
@@ -285,6 +428,11 @@ SearchesManager* SearchesManager::getInstance()
 
 SearchInformation* SearchesManager::getSearchEngine(const QString &identifier)
 {
+	if (!m_isLoaded)
+	{
+		loadSearchEngines();
+	}
+
 	return m_searchEngines.value(identifier, NULL);
 }
 
@@ -302,60 +450,152 @@ QStandardItemModel* SearchesManager::getSearchEnginesModel()
 
 QStringList SearchesManager::getSearchEngines()
 {
-	const QString path = SettingsManager::getPath() + QLatin1String("/searches/");
-	const QDir directory(path);
-
-	if (!QFile::exists(path))
+	if (!m_isLoaded)
 	{
-		QDir().mkpath(path);
+		loadSearchEngines();
+	}
+
+	return m_searchEnginesOrder;
+}
 
-		if (directory.entryList(QDir::Files).isEmpty())
+QString SearchesManager::expandTemplate(const QString &pattern, const QString &query)
+{
+	const QList<SearchTemplateToken> tokens = getTemplate(pattern);
+	QString result;
+	result.reserve(pattern.length() + query.length());
+
+	for (int i = 0; i < tokens.count(); ++i)
+	{
+		switch (tokens.at(i).variable)
 		{
-			const QStringList definitions = QDir(QLatin1String(":/searches/")).entryList(QDir::Files);
+			case NoVariable:
+				result.append(tokens.at(i).text);
 
-			for (int i = 0; i < definitions.count(); ++i)
-			{
-				QFile::copy(QLatin1String(":/searches/") + definitions.at(i), directory.filePath(definitions.at(i)));
-				QFile::setPermissions(directory.filePath(definitions.at(i)), (QFileDevice::ReadOwner | QFileDevice::WriteOwner | QFileDevice::ReadGroup | QFileDevice::ReadOther));
-			}
+				break;
+			case SearchTermsVariable:
+				result.append(query);
+
+				break;
+			case LanguageVariable:
+				if (m_language.isEmpty())
+				{
+					m_language = QLocale::system().name();
+				}
+
+				result.append(m_language);
+
+				break;
+			case InputEncodingVariable:
+			case OutputEncodingVariable:
+				result.append(QLatin1String("UTF-8"));
+
+				break;
+			default:
+				break;
 		}
 	}
 
-	if (m_searchEngines.isEmpty())
+	return result;
+}
+
+QString SearchesManager::getSearchEnginesPath()
+{
+	return SettingsManager::getPath() + QLatin1String("/searches/");
+}
+
+QList<SearchTemplateToken> SearchesManager::getTemplate(const QString &pattern)
+{
+	if (m_templates.contains(pattern))
+	{
+		return m_templates[pattern];
+	}
+
+	QList<SearchTemplateToken> tokens;
+	QString text;
+	int position = 0;
+
+	while (position < pattern.length())
 	{
-		const QStringList entries = directory.entryList(QDir::Files);
+		const int start = pattern.indexOf(QLatin1Char('{'), position);
+		const int end = ((start >= 0) ? pattern.indexOf(QLatin1Char('}'), start) : -1);
+
+		if (start < 0 || end < 0)
+		{
+			text.append(pattern.mid(position));
+
+			break;
+		}
+
+		const QString name = pattern.mid((start + 1), (end - start - 1));
+		SearchTemplateVariable variable = NoVariable;
+
+		if (name == QLatin1String("searchTerms"))
+		{
+			variable = SearchTermsVariable;
+		}
+		else if (name == QLatin1String("count"))
+		{
+			variable = CountVariable;
+		}
+		else if (name == QLatin1String("startIndex"))
+		{
+			variable = StartIndexVariable;
+		}
+		else if (name == QLatin1String("startPage"))
+		{
+			variable = StartPageVariable;
+		}
+		else if (name == QLatin1String("language"))
+		{
+			variable = LanguageVariable;
+		}
+		else if (name == QLatin1String("inputEncoding"))
+		{
+			variable = InputEncodingVariable;
+		}
+		else if (name == QLatin1String("outputEncoding"))
+		{
+			variable = OutputEncodingVariable;
+		}
 
-		for (int i = 0; i < entries.count(); ++i)
+		if (variable == NoVariable)
+		{
+			text.append(pattern.mid(position, (end - position + 1)));
+		}
+		else
 		{
-			QFile file(directory.absoluteFilePath(entries.at(i)));
+			text.append(pattern.mid(position, (start - position)));
 
-			if (file.open(QIODevice::ReadOnly))
+			if (!text.isEmpty())
 			{
-				const QString identifier = QFileInfo(entries.at(i)).baseName();
-				SearchInformation *search = readSearch(&file, identifier);
+				SearchTemplateToken token;
+				token.text = text;
 
-				if (search)
-				{
-					m_searchEngines[identifier] = search;
-				}
+				tokens.append(token);
 
-				file.close();
+				text.clear();
 			}
+
+			SearchTemplateToken token;
+			token.variable = variable;
+
+			tokens.append(token);
 		}
 
-		m_searchEnginesOrder = SettingsManager::getValue(QLatin1String("Browser/SearchEnginesOrder")).toStringList();
-		m_searchEnginesOrder.removeAll(QString());
+		position = (end + 1);
+	}
 
-		if (m_searchEnginesOrder.isEmpty())
-		{
-			QStringList engines = m_searchEngines.keys();
-			engines.sort();
+	if (!text.isEmpty())
+	{
+		SearchTemplateToken token;
+		token.text = text;
 
-			m_searchEnginesOrder = engines;
-		}
+		tokens.append(token);
 	}
 
-	return m_searchEnginesOrder;
+	m_templates[pattern] = tokens;
+
+	return tokens;
 }
 
 QStringList SearchesManager::getSearchShortcuts()
@@ -471,7 +711,7 @@ bool SearchesManager::setSearchEngines(const QList<SearchInformation*> &engines)
 	{
 		if (!engines.contains(existingEngines.at(i)))
 		{
-			const QString path = SettingsManager::getPath() + QLatin1String("/searches/") + QString(existingEngines.at(i)->identifier).remove(QRegularExpression(QLatin1String("[\\/\\\\]"))) + QLatin1String(".xml");
+			const QString path = getSearchEnginesPath() + QString(existingEngines.at(i)->identifier).remove(QRegularExpression(QLatin1String("[\\/\\\\]"))) + QLatin1String(".xml");
 
 			if (QFile::exists(path) && !QFile::remove(path))
 			{
@@ -481,6 +721,7 @@ bool SearchesManager::setSearchEngines(const QList<SearchInformation*> &engines)
 			}
 
 			m_searchEngines.remove(existingEngines.at(i)->identifier);
+			m_modificationTimes.remove(existingEngines.at(i)->identifier);
 			m_searchEnginesOrder.removeAll(existingEngines.at(i)->identifier);
 
 			delete existingEngines.at(i);
@@ -498,7 +739,7 @@ bool SearchesManager::setSearchEngines(const QList<SearchInformation*> &engines)
 			continue;
 		}
 
-		QFile file(SettingsManager::getPath() + QLatin1String("/searches/") + QString(engines.at(i)->identifier).remove(QRegularExpression("[\\/\\\\]")) + ".xml");
+		QFile file(getSearchEnginesPath() + QString(engines.at(i)->identifier).remove(QRegularExpression("[\\/\\\\]")) + ".xml");
 
 		if (!file.open(QIODevice::WriteOnly) || !writeSearch(&file, engines.at(i)))
 		{
@@ -519,6 +760,7 @@ bool SearchesManager::setSearchEngines(const QList<SearchInformation*> &engines)
 		file.close();
 
 		m_searchEngines[engines.at(i)->identifier] = engines.at(i);
+		m_modificationTimes[engines.at(i)->identifier] = QFileInfo(file.fileName()).lastModified();
 
 		m_searchEnginesOrder.append(engines.at(i)->identifier);
 	}
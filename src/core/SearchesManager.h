@@ -20,7 +20,9 @@
 #ifndef OTTER_SEARCHESMANAGER_H
 #define OTTER_SEARCHESMANAGER_H
 
+#include <QtCore/QDateTime>
 #include <QtCore/QFile>
+#include <QtCore/QFileSystemWatcher>
 #include <QtCore/QUrlQuery>
 #include <QtGui/QIcon>
 #include <QtGui/QStandardItemModel>
@@ -29,6 +31,26 @@
 namespace Otter
 {
 
+enum SearchTemplateVariable
+{
+	NoVariable = 0,
+	SearchTermsVariable = 1,
+	CountVariable = 2,
+	StartIndexVariable = 3,
+	StartPageVariable = 4,
+	LanguageVariable = 5,
+	InputEncodingVariable = 6,
+	OutputEncodingVariable = 7
+};
+
+struct SearchTemplateToken
+{
+	QString text;
+	SearchTemplateVariable variable;
+
+	SearchTemplateToken() : variable(NoVariable) {}
+};
+
 struct SearchUrl
 {
 	QString url;
@@ -68,16 +90,32 @@ public:
 	static bool setSearchEngines(const QList<SearchInformation*> &engines);
 
 protected:
+	void timerEvent(QTimerEvent *event);
 	void updateSearchEnginesModel();
+	static void loadSearchEngines();
+	static void compileSearchUrl(const SearchUrl &searchUrl);
+	static QString expandTemplate(const QString &pattern, const QString &query);
+	static QString getSearchEnginesPath();
+	static QList<SearchTemplateToken> getTemplate(const QString &pattern);
+
+protected slots:
+	void scheduleReload();
 
 private:
 	explicit SearchesManager(QObject *parent = NULL);
 
+	QFileSystemWatcher *m_watcher;
+	int m_reloadTimer;
+
 	static SearchesManager *m_instance;
 	static QStandardItemModel *m_searchEnginesModel;
 	static QStringList m_searchEnginesOrder;
 	static QStringList m_searchShortcuts;
+	static QString m_language;
 	static QHash<QString, SearchInformation*> m_searchEngines;
+	static QHash<QString, QDateTime> m_modificationTimes;
+	static QHash<QString, QList<SearchTemplateToken> > m_templates;
+	static bool m_isLoaded;
 
 signals:
 	void searchEnginesModified();
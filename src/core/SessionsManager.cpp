@@ -23,7 +23,10 @@
 #include "WindowsManager.h"
 #include "../ui/MainWindow.h"
 
+#include <QtCore/QDateTime>
 #include <QtCore/QDir>
+#include <QtCore/QMap>
+#include <QtCore/QSaveFile>
 #include <QtCore/QSettings>
 
 namespace Otter
@@ -34,6 +37,12 @@ QPointer<QWidget> SessionsManager::m_activeWindow = NULL;
 QString SessionsManager::m_session;
 QList<WindowsManager*> SessionsManager::m_managers;
 QList<SessionEntry> SessionsManager::m_closedWindows;
+QHash<WindowsManager*, QByteArray> SessionsManager::m_sessionData;
+QSet<WindowsManager*> SessionsManager::m_modifiedManagers;
+QHash<WindowsManager*, quint32> SessionsManager::m_journalIdentifiers;
+QFile* SessionsManager::m_journal = NULL;
+quint32 SessionsManager::m_journalIdentifier = 0;
+int SessionsManager::m_journalRecords = 0;
 bool SessionsManager::m_dirty = false;
 
 SessionsManager::SessionsManager(QObject *parent) : QObject(parent),
@@ -51,7 +60,10 @@ void SessionsManager::timerEvent(QTimerEvent *event)
 
 		m_autoSaveTimer = 0;
 
-		saveSession();
+		if (!m_journal || m_journalRecords >= SettingsManager::getValue(QLatin1String("Sessions/JournalLimit")).toInt())
+		{
+			saveSession();
+		}
 	}
 }
 
@@ -63,6 +75,177 @@ void SessionsManager::scheduleAutoSave()
 	}
 }
 
+void SessionsManager::openJournal(const QString &path, quint64 serial, const QList<MainWindow*> &windows)
+{
+	closeJournal();
+
+	m_journal = new QFile(getJournalPath(path), m_instance);
+
+	if (!m_journal->open(QIODevice::WriteOnly | QIODevice::Truncate))
+	{
+		closeJournal();
+
+		return;
+	}
+
+	QDataStream stream(m_journal);
+	stream.setVersion(QDataStream::Qt_5_0);
+	stream << quint32(0x4F534A4E) << quint16(1) << serial;
+
+	m_journal->flush();
+
+	for (int i = 0; i < windows.count(); ++i)
+	{
+		m_journalIdentifiers[windows.at(i)->getWindowsManager()] = i;
+	}
+
+	m_journalIdentifier = windows.count();
+}
+
+void SessionsManager::closeJournal()
+{
+	if (m_journal)
+	{
+		m_journal->close();
+		m_journal->deleteLater();
+		m_journal = NULL;
+	}
+
+	m_journalIdentifiers.clear();
+	m_journalIdentifier = 0;
+	m_journalRecords = 0;
+}
+
+void SessionsManager::replayJournal(const QString &path, quint64 serial, QList<SessionEntry> &windows)
+{
+	QFile file(getJournalPath(path));
+
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		return;
+	}
+
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_0);
+
+	quint32 magic;
+	quint16 version;
+	quint64 journalSerial;
+
+	stream >> magic >> version >> journalSerial;
+
+	if (magic != 0x4F534A4E || version != 1 || journalSerial != serial)
+	{
+		return;
+	}
+
+	QMap<quint32, SessionEntry> entries;
+
+	for (int i = 0; i < windows.count(); ++i)
+	{
+		entries[i] = windows.at(i);
+	}
+
+	while (!stream.atEnd())
+	{
+		QByteArray data;
+
+		stream >> data;
+
+		if (stream.status() != QDataStream::Ok)
+		{
+			break;
+		}
+
+		QDataStream recordStream(data);
+		recordStream.setVersion(QDataStream::Qt_5_0);
+
+		quint8 record;
+		quint32 identifier;
+		qint32 index;
+		qint32 target;
+		QByteArray payload;
+
+		recordStream >> record >> identifier >> index >> target >> payload;
+
+		if (recordStream.status() != QDataStream::Ok || (record != OpenSessionRecord && !entries.contains(identifier)))
+		{
+			continue;
+		}
+
+		SessionEntry &entry = entries[identifier];
+
+		switch (record)
+		{
+			case OpenSessionRecord:
+				entry = SessionEntry();
+
+				break;
+			case CloseSessionRecord:
+				entries.remove(identifier);
+
+				break;
+			case UpdateSessionRecord:
+				entry = deserializeSession(payload);
+
+				break;
+			case OpenWindowRecord:
+				{
+					QDataStream windowStream(payload);
+					windowStream.setVersion(QDataStream::Qt_5_0);
+
+					entry.windows.insert(qBound(0, index, entry.windows.count()), readSessionWindow(windowStream));
+				}
+
+				break;
+			case CloseWindowRecord:
+				if (index >= 0 && index < entry.windows.count())
+				{
+					entry.windows.removeAt(index);
+				}
+
+				break;
+			case UpdateWindowRecord:
+				if (index >= 0 && index < entry.windows.count())
+				{
+					QDataStream windowStream(payload);
+					windowStream.setVersion(QDataStream::Qt_5_0);
+
+					entry.windows[index] = readSessionWindow(windowStream);
+				}
+
+				break;
+			case MoveWindowRecord:
+				if (index >= 0 && index < entry.windows.count() && target >= 0 && target < entry.windows.count())
+				{
+					entry.windows.move(index, target);
+				}
+
+				break;
+			case ActivateWindowRecord:
+				entry.index = index;
+
+				break;
+			default:
+				break;
+		}
+	}
+
+	windows = entries.values();
+}
+
+void SessionsManager::writeSessionWindow(QDataStream &stream, const SessionWindow &window)
+{
+	const QString defaultSearchEngine = SettingsManager::getValue(QLatin1String("Browser/DefaultSearchEngine")).toString();
+
+	stream << ((defaultSearchEngine == window.searchEngine) ? QString() : window.searchEngine) << qint32(window.group) << qint32(window.index) << window.pinned << qint32(window.history.count());
+
+	for (int i = 0; i < window.history.count(); ++i)
+	{
+		stream << window.history.at(i).url << window.history.at(i).title << window.history.at(i).position << qint32(window.history.at(i).zoom);
+	}
+}
+
 void SessionsManager::createInstance(QObject *parent)
 {
 	m_instance = new SessionsManager(parent);
@@ -80,9 +263,19 @@ void SessionsManager::registerWindow(WindowsManager *manager)
 	if (manager)
 	{
 		m_managers.append(manager);
+
+		recordSessionEvent(manager, OpenSessionRecord);
 	}
 }
 
+void SessionsManager::unregisterWindow(WindowsManager *manager)
+{
+	m_managers.removeAll(manager);
+	m_sessionData.remove(manager);
+	m_modifiedManagers.remove(manager);
+	m_journalIdentifiers.remove(manager);
+}
+
 void SessionsManager::storeClosedWindow(WindowsManager *manager)
 {
 	if (!manager)
@@ -90,7 +283,8 @@ void SessionsManager::storeClosedWindow(WindowsManager *manager)
 		return;
 	}
 
-	m_managers.removeAll(manager);
+	recordSessionEvent(manager, CloseSessionRecord);
+	unregisterWindow(manager);
 
 	SessionEntry session = manager->getSession();
 
@@ -102,8 +296,19 @@ void SessionsManager::storeClosedWindow(WindowsManager *manager)
 	}
 }
 
-void SessionsManager::markSessionModified()
+void SessionsManager::markSessionModified(WindowsManager *manager)
 {
+	if (manager)
+	{
+		m_modifiedManagers.insert(manager);
+	}
+	else
+	{
+		m_sessionData.clear();
+
+		closeJournal();
+	}
+
 	if (m_session == QLatin1String("default") && !m_dirty)
 	{
 		m_dirty = true;
@@ -112,6 +317,62 @@ void SessionsManager::markSessionModified()
 	}
 }
 
+void SessionsManager::recordSessionEvent(WindowsManager *manager, SessionRecord record, int index, int target, const SessionWindow &window)
+{
+	if (record != CloseSessionRecord)
+	{
+		markSessionModified(manager);
+	}
+
+	if (!m_journal)
+	{
+		return;
+	}
+
+	if (!m_journalIdentifiers.contains(manager))
+	{
+		if (record != OpenSessionRecord)
+		{
+			return;
+		}
+
+		m_journalIdentifiers[manager] = m_journalIdentifier;
+
+		++m_journalIdentifier;
+	}
+	else if (record == OpenSessionRecord)
+	{
+		return;
+	}
+
+	QByteArray payload;
+
+	if (record == UpdateSessionRecord)
+	{
+		payload = serializeSession(manager->getSession());
+	}
+	else if (record == OpenWindowRecord || record == UpdateWindowRecord)
+	{
+		QDataStream windowStream(&payload, QIODevice::WriteOnly);
+		windowStream.setVersion(QDataStream::Qt_5_0);
+
+		writeSessionWindow(windowStream, window);
+	}
+
+	QByteArray data;
+	QDataStream recordStream(&data, QIODevice::WriteOnly);
+	recordStream.setVersion(QDataStream::Qt_5_0);
+	recordStream << quint8(record) << m_journalIdentifiers.value(manager) << qint32(index) << qint32(target) << payload;
+
+	QDataStream stream(m_journal);
+	stream.setVersion(QDataStream::Qt_5_0);
+	stream << data;
+
+	m_journal->flush();
+
+	++m_journalRecords;
+}
+
 void SessionsManager::removeStoredUrl(const QString &url)
 {
 	emit m_instance->requestedRemoveStoredUrl(url);
@@ -143,13 +404,13 @@ QString SessionsManager::getSessionPath(const QString &path, bool bound)
 
 	if (cleanPath.isEmpty())
 	{
-		cleanPath = QLatin1String("default.ini");
+		cleanPath = QLatin1String("default.dat");
 	}
 	else
 	{
-		if (!cleanPath.endsWith(QLatin1String(".ini")))
+		if (!cleanPath.endsWith(QLatin1String(".dat")) && !cleanPath.endsWith(QLatin1String(".ini")))
 		{
-			cleanPath += QLatin1String(".ini");
+			cleanPath += QLatin1String(".dat");
 		}
 
 		if (bound)
@@ -165,6 +426,54 @@ QString SessionsManager::getSessionPath(const QString &path, bool bound)
 	return SettingsManager::getPath() + QLatin1String("/sessions/") + cleanPath;
 }
 
+QString SessionsManager::getLegacySessionPath(const QString &path)
+{
+	if (path.endsWith(QLatin1String(".dat")))
+	{
+		return path.left(path.length() - 4) + QLatin1String(".ini");
+	}
+
+	return path;
+}
+
+QString SessionsManager::getJournalPath(const QString &path)
+{
+	if (path.endsWith(QLatin1String(".dat")))
+	{
+		return path.left(path.length() - 4) + QLatin1String(".journal");
+	}
+
+	return path + QLatin1String(".journal");
+}
+
+QString SessionsManager::getSessionTitle(const QString &path)
+{
+	QFile file(path);
+
+	if (file.open(QIODevice::ReadOnly))
+	{
+		QDataStream stream(&file);
+		stream.setVersion(QDataStream::Qt_5_0);
+
+		quint32 magic;
+		quint16 version;
+		QString title;
+
+		stream >> magic >> version;
+
+		if (magic == 0x4F534553 && (version == 1 || version == 2))
+		{
+			stream >> title;
+
+			return title;
+		}
+
+		file.close();
+	}
+
+	return QSettings(getLegacySessionPath(path), QSettings::IniFormat).value(QLatin1String("Session/title")).toString();
+}
+
 QStringList SessionsManager::getClosedWindows()
 {
 	QStringList closedWindows;
@@ -180,9 +489,138 @@ QStringList SessionsManager::getClosedWindows()
 	return closedWindows;
 }
 
+QByteArray SessionsManager::serializeSession(const SessionEntry &session)
+{
+	QByteArray data;
+	QDataStream stream(&data, QIODevice::WriteOnly);
+	stream.setVersion(QDataStream::Qt_5_0);
+	stream << qint32(session.index) << qint32(session.windows.count());
+
+	for (int i = 0; i < session.windows.count(); ++i)
+	{
+		writeSessionWindow(stream, session.windows.at(i));
+	}
+
+	return data;
+}
+
+SessionEntry SessionsManager::deserializeSession(const QByteArray &data)
+{
+	QDataStream stream(data);
+	stream.setVersion(QDataStream::Qt_5_0);
+
+	SessionEntry session;
+	qint32 index;
+	qint32 windows;
+
+	stream >> index >> windows;
+
+	session.index = index;
+
+	for (qint32 i = 0; i < windows && stream.status() == QDataStream::Ok; ++i)
+	{
+		session.windows.append(readSessionWindow(stream));
+	}
+
+	return session;
+}
+
+SessionWindow SessionsManager::readSessionWindow(QDataStream &stream)
+{
+	SessionWindow window;
+	qint32 group;
+	qint32 index;
+	qint32 history;
+
+	stream >> window.searchEngine >> group >> index >> window.pinned >> history;
+
+	window.group = group;
+	window.index = index;
+
+	for (qint32 i = 0; i < history && stream.status() == QDataStream::Ok; ++i)
+	{
+		WindowHistoryEntry historyEntry;
+		qint32 zoom;
+
+		stream >> historyEntry.url >> historyEntry.title >> historyEntry.position >> zoom;
+
+		historyEntry.zoom = zoom;
+
+		window.history.append(historyEntry);
+	}
+
+	return window;
+}
+
 SessionInformation SessionsManager::getSession(const QString &path)
 {
-	const QString sessionPath = getSessionPath(path);
+	QString sessionPath = getSessionPath(path);
+
+	if (!QFile::exists(sessionPath) && QFile::exists(getLegacySessionPath(sessionPath)))
+	{
+		sessionPath = getLegacySessionPath(sessionPath);
+	}
+
+	QFile file(sessionPath);
+
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		return getLegacySession(path, sessionPath);
+	}
+
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_0);
+
+	quint32 magic;
+	quint16 version;
+
+	stream >> magic >> version;
+
+	if (magic != 0x4F534553 || (version != 1 && version != 2))
+	{
+		file.close();
+
+		return getLegacySession(path, sessionPath);
+	}
+
+	QString title;
+	quint64 serial = 0;
+	qint32 index;
+	qint32 windows;
+
+	stream >> title;
+
+	if (version > 1)
+	{
+		stream >> serial;
+	}
+
+	stream >> index >> windows;
+
+	SessionInformation session;
+	session.path = path;
+	session.title = (title.isEmpty() ? ((path == QLatin1String("default")) ? tr("Default") : tr("(Untitled)")) : title);
+	session.index = index;
+
+	for (qint32 i = 0; i < windows && stream.status() == QDataStream::Ok; ++i)
+	{
+		QByteArray data;
+
+		stream >> data;
+
+		session.windows.append(deserializeSession(data));
+	}
+
+	if (serial > 0)
+	{
+		replayJournal(sessionPath, serial, session.windows);
+	}
+
+	return session;
+}
+
+SessionInformation SessionsManager::getLegacySession(const QString &path, const QString &sessionPath)
+{
 	const QSettings sessionData(sessionPath, QSettings::IniFormat);
 	const int windows = sessionData.value(QLatin1String("Session/windows"), 0).toInt();
 	SessionInformation session;
@@ -226,13 +664,15 @@ SessionInformation SessionsManager::getSession(const QString &path)
 
 QStringList SessionsManager::getSessions()
 {
-	QStringList entries = QDir(SettingsManager::getPath() + QLatin1String("/sessions/")).entryList(QStringList(QLatin1String("*.ini")), QDir::Files);
+	QStringList entries = QDir(SettingsManager::getPath() + QLatin1String("/sessions/")).entryList((QStringList(QLatin1String("*.dat")) << QLatin1String("*.ini")), QDir::Files);
 
 	for (int i = 0; i < entries.count(); ++i)
 	{
 		entries[i] = QFileInfo(entries.at(i)).completeBaseName();
 	}
 
+	entries.removeDuplicates();
+
 	if (!m_session.isEmpty() && !entries.contains(m_session))
 	{
 		entries.append(m_session);
@@ -289,7 +729,7 @@ bool SessionsManager::restoreSession(const QString &path, MainWindow *window)
 
 	if (window && m_closedWindows.count() > 0)
 	{
-		window->getWindowsManager()->restore(m_closedWindows.first().windows);
+		window->getWindowsManager()->restore(m_closedWindows.first());
 
 		m_closedWindows.removeAt(0);
 	}
@@ -322,14 +762,68 @@ bool SessionsManager::saveSession(const QString &path, const QString &title, Mai
 	QDir().mkpath(SettingsManager::getPath() + QLatin1String("/sessions/"));
 
 	const QString sessionPath = getSessionPath(path);
-	QString sessionTitle = QSettings(sessionPath, QSettings::IniFormat).value(QLatin1String("Session/title")).toString();
+	const QString sessionTitle = (title.isEmpty() ? getSessionTitle(sessionPath) : title);
 
-	if (!title.isEmpty())
+	if (sessionPath.endsWith(QLatin1String(".ini")))
 	{
-		sessionTitle = title;
+		return saveLegacySession(sessionPath, sessionTitle, windows);
 	}
 
-	QFile file(sessionPath);
+	QSaveFile file(sessionPath);
+
+	if (!file.open(QIODevice::WriteOnly))
+	{
+		return false;
+	}
+
+	const quint64 serial = QDateTime::currentMSecsSinceEpoch();
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_0);
+	stream << quint32(0x4F534553) << quint16(2) << sessionTitle << serial << qint32(0) << qint32(windows.count());
+
+	for (int i = 0; i < windows.count(); ++i)
+	{
+		WindowsManager *manager = windows.at(i)->getWindowsManager();
+
+		if (m_modifiedManagers.contains(manager) || !m_sessionData.contains(manager))
+		{
+			m_sessionData[manager] = serializeSession(manager->getSession());
+
+			m_modifiedManagers.remove(manager);
+		}
+
+		stream << m_sessionData.value(manager);
+	}
+
+	if (stream.status() != QDataStream::Ok)
+	{
+		file.cancelWriting();
+	}
+
+	if (!file.commit())
+	{
+		return false;
+	}
+
+	if (m_session == QLatin1String("default") && sessionPath == getSessionPath(m_session))
+	{
+		if (window)
+		{
+			closeJournal();
+		}
+		else
+		{
+			openJournal(sessionPath, serial, windows);
+		}
+	}
+
+	return true;
+}
+
+bool SessionsManager::saveLegacySession(const QString &path, const QString &title, const QList<MainWindow*> &windows)
+{
+	QString sessionTitle = title;
+	QFile file(path);
 
 	if (!file.open(QIODevice::WriteOnly))
 	{
@@ -380,18 +874,41 @@ bool SessionsManager::saveSession(const QString &path, const QString &title, Mai
 bool SessionsManager::deleteSession(const QString &path)
 {
 	const QString cleanPath = getSessionPath(path, true);
+	bool removed = false;
 
 	if (QFile::exists(cleanPath))
 	{
-		return QFile::remove(cleanPath);
+		removed = QFile::remove(cleanPath);
 	}
 
-	return false;
+	if (QFile::exists(getLegacySessionPath(cleanPath)))
+	{
+		removed = (QFile::remove(getLegacySessionPath(cleanPath)) || removed);
+	}
+
+	if (QFile::exists(getJournalPath(cleanPath)))
+	{
+		QFile::remove(getJournalPath(cleanPath));
+	}
+
+	return removed;
 }
 
 bool SessionsManager::moveSession(const QString &from, const QString &to)
 {
-	return QFile::rename(getSessionPath(from), getSessionPath(to));
+	const QString sessionPath = getSessionPath(from);
+
+	if (!QFile::exists(sessionPath) && QFile::exists(getLegacySessionPath(sessionPath)))
+	{
+		return QFile::rename(getLegacySessionPath(sessionPath), getLegacySessionPath(getSessionPath(to)));
+	}
+
+	if (QFile::exists(getJournalPath(sessionPath)))
+	{
+		QFile::rename(getJournalPath(sessionPath), getJournalPath(getSessionPath(to)));
+	}
+
+	return QFile::rename(sessionPath, getSessionPath(to));
 }
 
 bool SessionsManager::isLastWindow()
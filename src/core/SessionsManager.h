@@ -21,12 +21,29 @@
 #define OTTER_SESSIONSMANAGER_H
 
 #include <QtCore/QCoreApplication>
+#include <QtCore/QDataStream>
+#include <QtCore/QFile>
+#include <QtCore/QHash>
 #include <QtCore/QPoint>
 #include <QtCore/QPointer>
+#include <QtCore/QSet>
 
 namespace Otter
 {
 
+enum SessionRecord
+{
+	UnknownRecord = 0,
+	OpenSessionRecord = 1,
+	CloseSessionRecord = 2,
+	UpdateSessionRecord = 3,
+	OpenWindowRecord = 4,
+	CloseWindowRecord = 5,
+	UpdateWindowRecord = 6,
+	MoveWindowRecord = 7,
+	ActivateWindowRecord = 8
+};
+
 struct WindowHistoryEntry
 {
 	QString url;
@@ -115,8 +132,10 @@ public:
 	static void createInstance(QObject *parent = NULL);
 	static void clearClosedWindows();
 	static void registerWindow(WindowsManager *manager);
+	static void unregisterWindow(WindowsManager *manager);
 	static void storeClosedWindow(WindowsManager *manager);
-	static void markSessionModified();
+	static void markSessionModified(WindowsManager *manager = NULL);
+	static void recordSessionEvent(WindowsManager *manager, SessionRecord record, int index = -1, int target = -1, const SessionWindow &window = SessionWindow());
 	static void removeStoredUrl(const QString &url);
 	static void setActiveWindow(QWidget *window);
 	static SessionsManager* getInstance();
@@ -137,6 +156,18 @@ public:
 protected:
 	void timerEvent(QTimerEvent *event);
 	void scheduleAutoSave();
+	static void openJournal(const QString &path, quint64 serial, const QList<MainWindow*> &windows);
+	static void closeJournal();
+	static void replayJournal(const QString &path, quint64 serial, QList<SessionEntry> &windows);
+	static void writeSessionWindow(QDataStream &stream, const SessionWindow &window);
+	static QString getLegacySessionPath(const QString &path);
+	static QString getJournalPath(const QString &path);
+	static QString getSessionTitle(const QString &path);
+	static QByteArray serializeSession(const SessionEntry &session);
+	static SessionEntry deserializeSession(const QByteArray &data);
+	static SessionWindow readSessionWindow(QDataStream &stream);
+	static SessionInformation getLegacySession(const QString &path, const QString &sessionPath);
+	static bool saveLegacySession(const QString &path, const QString &title, const QList<MainWindow*> &windows);
 
 private:
 	explicit SessionsManager(QObject *parent = NULL);
@@ -148,6 +179,12 @@ private:
 	static QString m_session;
 	static QList<WindowsManager*> m_managers;
 	static QList<SessionEntry> m_closedWindows;
+	static QHash<WindowsManager*, QByteArray> m_sessionData;
+	static QSet<WindowsManager*> m_modifiedManagers;
+	static QHash<WindowsManager*, quint32> m_journalIdentifiers;
+	static QFile *m_journal;
+	static quint32 m_journalIdentifier;
+	static int m_journalRecords;
 	static bool m_dirty;
 
 signals:
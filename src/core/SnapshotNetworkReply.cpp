@@ -0,0 +1,119 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2013 - 2014 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "SnapshotNetworkReply.h"
+#include "SnapshotsManager.h"
+
+#include <QtCore/QTimer>
+
+namespace Otter
+{
+
+SnapshotNetworkReply::SnapshotNetworkReply(QObject *parent, const QNetworkRequest &request, QAbstractNetworkCache *cache) : QNetworkReply(parent),
+	m_offset(0)
+{
+	setRequest(request);
+	setUrl(request.url());
+	setOperation(QNetworkAccessManager::GetOperation);
+
+	open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+
+	SnapshotResource resource;
+	const bool isHit = SnapshotsManager::getResource(request.url(), &resource);
+
+	SnapshotsManager::recordLoad(isHit);
+
+	if (isHit)
+	{
+		m_content = SnapshotsManager::getData(resource);
+
+		for (int i = 0; i < resource.headers.count(); ++i)
+		{
+			setRawHeader(resource.headers.at(i).first, resource.headers.at(i).second);
+		}
+
+		setAttribute(QNetworkRequest::HttpStatusCodeAttribute, resource.status);
+	}
+	else
+	{
+		const QNetworkCacheMetaData metaData = (cache ? cache->metaData(request.url()) : QNetworkCacheMetaData());
+		QIODevice *device = (metaData.isValid() ? cache->data(request.url()) : NULL);
+
+		if (!device)
+		{
+			setError(ContentNotFoundError, tr("Resource is not available offline"));
+
+			QTimer::singleShot(0, this, SIGNAL(finished()));
+
+			return;
+		}
+
+		m_content = device->readAll();
+
+		device->deleteLater();
+
+		const QList<QNetworkCacheMetaData::RawHeader> headers = metaData.rawHeaders();
+
+		for (int i = 0; i < headers.count(); ++i)
+		{
+			setRawHeader(headers.at(i).first, headers.at(i).second);
+		}
+
+		setAttribute(QNetworkRequest::HttpStatusCodeAttribute, metaData.attributes().value(QNetworkRequest::HttpStatusCodeAttribute, 200));
+	}
+
+	setHeader(QNetworkRequest::ContentLengthHeader, QVariant(m_content.size()));
+	setAttribute(QNetworkRequest::SourceIsFromCacheAttribute, true);
+
+	QTimer::singleShot(0, this, SIGNAL(metaDataChanged()));
+	QTimer::singleShot(0, this, SIGNAL(readyRead()));
+	QTimer::singleShot(0, this, SIGNAL(finished()));
+}
+
+void SnapshotNetworkReply::abort()
+{
+}
+
+qint64 SnapshotNetworkReply::bytesAvailable() const
+{
+	return (m_content.size() - m_offset);
+}
+
+qint64 SnapshotNetworkReply::readData(char *data, qint64 maxSize)
+{
+	if (m_offset < m_content.size())
+	{
+		qint64 number = qMin(maxSize, m_content.size() - m_offset);
+
+		memcpy(data, (m_content.constData() + m_offset), number);
+
+		m_offset += number;
+
+		return number;
+	}
+
+	return -1;
+}
+
+bool SnapshotNetworkReply::isSequential() const
+{
+	return true;
+}
+
+}
@@ -0,0 +1,409 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2013 - 2014 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "SnapshotsManager.h"
+#include "NetworkAccessManager.h"
+#include "NetworkCache.h"
+#include "SettingsManager.h"
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDataStream>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QSaveFile>
+#include <QtCore/QSet>
+#include <QtCore/QTimerEvent>
+
+namespace Otter
+{
+
+SnapshotsManager* SnapshotsManager::m_instance = NULL;
+NetworkAccessManager* SnapshotsManager::m_networkAccessManager = NULL;
+QHash<QUrl, QList<QUrl> > SnapshotsManager::m_snapshots;
+QHash<QUrl, SnapshotResource> SnapshotsManager::m_resources;
+QHash<QByteArray, int> SnapshotsManager::m_references;
+int SnapshotsManager::m_hits = 0;
+int SnapshotsManager::m_misses = 0;
+
+SnapshotsManager::SnapshotsManager(QObject *parent) : QObject(parent),
+	m_saveTimer(0)
+{
+	load();
+}
+
+SnapshotsManager::~SnapshotsManager()
+{
+	if (m_saveTimer != 0)
+	{
+		save();
+	}
+}
+
+void SnapshotsManager::createInstance(QObject *parent)
+{
+	m_instance = new SnapshotsManager(parent);
+}
+
+void SnapshotsManager::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() == m_saveTimer)
+	{
+		killTimer(m_saveTimer);
+
+		m_saveTimer = 0;
+
+		save();
+	}
+}
+
+void SnapshotsManager::scheduleSave()
+{
+	if (m_saveTimer == 0)
+	{
+		m_saveTimer = startTimer(1000);
+	}
+}
+
+void SnapshotsManager::load()
+{
+	QFile file(getPath() + QLatin1String("index.dat"));
+
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		return;
+	}
+
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_0);
+
+	quint32 magic;
+	quint16 version;
+
+	stream >> magic >> version;
+
+	if (magic != 0x4F534E50 || version != 1)
+	{
+		return;
+	}
+
+	quint32 amount;
+
+	stream >> m_snapshots >> amount;
+
+	for (quint32 i = 0; i < amount && stream.status() == QDataStream::Ok; ++i)
+	{
+		QUrl url;
+		SnapshotResource resource;
+		qint32 status;
+
+		stream >> url >> resource.hash >> resource.headers >> resource.size >> status;
+
+		resource.status = status;
+
+		m_resources[url] = resource;
+
+		++m_references[resource.hash];
+	}
+}
+
+void SnapshotsManager::save()
+{
+	QSaveFile file(getPath() + QLatin1String("index.dat"));
+
+	if (!file.open(QIODevice::WriteOnly))
+	{
+		return;
+	}
+
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_0);
+	stream << quint32(0x4F534E50) << quint16(1) << m_snapshots << quint32(m_resources.count());
+
+	QHash<QUrl, SnapshotResource>::const_iterator iterator;
+
+	for (iterator = m_resources.constBegin(); iterator != m_resources.constEnd(); ++iterator)
+	{
+		stream << iterator.key() << iterator.value().hash << iterator.value().headers << iterator.value().size << qint32(iterator.value().status);
+	}
+
+	file.commit();
+}
+
+void SnapshotsManager::createSnapshot(const QUrl &url, const QList<QUrl> &resources)
+{
+	const QUrl pageUrl = normalizeUrl(url);
+	QList<QUrl> urls;
+	urls.append(pageUrl);
+
+	for (int i = 0; i < resources.count(); ++i)
+	{
+		const QUrl resourceUrl = normalizeUrl(resources.at(i));
+
+		if (!urls.contains(resourceUrl) && (resourceUrl.scheme() == QLatin1String("http") || resourceUrl.scheme() == QLatin1String("https")))
+		{
+			urls.append(resourceUrl);
+		}
+	}
+
+	NetworkCache *cache = NetworkAccessManager::getCache();
+
+	for (int i = 0; i < urls.count(); ++i)
+	{
+		const QNetworkCacheMetaData metaData = cache->metaData(urls.at(i));
+		QIODevice *device = (metaData.isValid() ? cache->data(urls.at(i)) : NULL);
+
+		if (device)
+		{
+			storeResource(urls.at(i), device->readAll(), metaData.rawHeaders(), metaData.attributes().value(QNetworkRequest::HttpStatusCodeAttribute, 200).toInt());
+
+			device->deleteLater();
+
+			continue;
+		}
+
+		QNetworkRequest request(urls.at(i));
+		request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::PreferCache);
+		request.setPriority(QNetworkRequest::LowPriority);
+
+		QNetworkReply *reply = getNetworkAccessManager()->get(request);
+
+		connect(reply, SIGNAL(finished()), m_instance, SLOT(resourceFetched()));
+	}
+
+	m_snapshots[pageUrl] = urls;
+
+	m_instance->scheduleSave();
+
+	emit m_instance->snapshotCreated(pageUrl);
+}
+
+void SnapshotsManager::removeSnapshot(const QUrl &url)
+{
+	const QUrl pageUrl = normalizeUrl(url);
+
+	if (!m_snapshots.contains(pageUrl))
+	{
+		return;
+	}
+
+	const QList<QUrl> urls = m_snapshots.take(pageUrl);
+	QSet<QUrl> usedUrls;
+	QHash<QUrl, QList<QUrl> >::const_iterator iterator;
+
+	for (iterator = m_snapshots.constBegin(); iterator != m_snapshots.constEnd(); ++iterator)
+	{
+		usedUrls.unite(iterator.value().toSet());
+	}
+
+	for (int i = 0; i < urls.count(); ++i)
+	{
+		if (usedUrls.contains(urls.at(i)) || !m_resources.contains(urls.at(i)))
+		{
+			continue;
+		}
+
+		const QByteArray hash = m_resources.take(urls.at(i)).hash;
+
+		--m_references[hash];
+
+		if (m_references[hash] <= 0)
+		{
+			m_references.remove(hash);
+
+			QFile::remove(getObjectPath(hash));
+		}
+	}
+
+	m_instance->scheduleSave();
+
+	emit m_instance->snapshotRemoved(pageUrl);
+}
+
+void SnapshotsManager::recordLoad(bool isHit)
+{
+	if (isHit)
+	{
+		++m_hits;
+	}
+	else
+	{
+		++m_misses;
+	}
+}
+
+void SnapshotsManager::resourceFetched()
+{
+	QNetworkReply *reply = qobject_cast<QNetworkReply*>(sender());
+
+	if (!reply)
+	{
+		return;
+	}
+
+	if (reply->error() == QNetworkReply::NoError)
+	{
+		storeResource(normalizeUrl(reply->url()), reply->readAll(), reply->rawHeaderPairs(), reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt());
+
+		scheduleSave();
+	}
+
+	reply->deleteLater();
+}
+
+void SnapshotsManager::storeResource(const QUrl &url, const QByteArray &data, const QList<QNetworkReply::RawHeaderPair> &headers, int status)
+{
+	SnapshotResource resource;
+	resource.hash = QCryptographicHash::hash(data, QCryptographicHash::Sha1).toHex();
+	resource.size = data.size();
+	resource.status = ((status > 0) ? status : 200);
+
+	for (int i = 0; i < headers.count(); ++i)
+	{
+		const QByteArray name = headers.at(i).first.toLower();
+
+		if (name != QByteArray("content-length") && name != QByteArray("content-encoding") && name != QByteArray("transfer-encoding") && name != QByteArray("set-cookie") && name != QByteArray("connection"))
+		{
+			resource.headers.append(headers.at(i));
+		}
+	}
+
+	const QString path = getObjectPath(resource.hash);
+
+	if (!QFile::exists(path))
+	{
+		QDir().mkpath(QFileInfo(path).absolutePath());
+
+		QSaveFile file(path);
+
+		if (!file.open(QIODevice::WriteOnly) || file.write(qCompress(data)) < 0 || !file.commit())
+		{
+			return;
+		}
+	}
+
+	if (m_resources.contains(url))
+	{
+		const QByteArray oldHash = m_resources[url].hash;
+
+		--m_references[oldHash];
+
+		if (m_references[oldHash] <= 0 && oldHash != resource.hash)
+		{
+			m_references.remove(oldHash);
+
+			QFile::remove(getObjectPath(oldHash));
+		}
+	}
+
+	m_resources[url] = resource;
+
+	++m_references[resource.hash];
+}
+
+NetworkAccessManager* SnapshotsManager::getNetworkAccessManager()
+{
+	if (!m_networkAccessManager)
+	{
+		m_networkAccessManager = new NetworkAccessManager(false, true, NULL);
+		m_networkAccessManager->setRequestClass(NetworkAccessManager::SnapshotRequestClass);
+		m_networkAccessManager->setParent(m_instance);
+	}
+
+	return m_networkAccessManager;
+}
+
+SnapshotsManager* SnapshotsManager::getInstance()
+{
+	return m_instance;
+}
+
+QString SnapshotsManager::getPath()
+{
+	return SettingsManager::getPath() + QLatin1String("/snapshots/");
+}
+
+QString SnapshotsManager::getObjectPath(const QByteArray &hash)
+{
+	return getPath() + QString::fromLatin1(hash.left(2)) + QLatin1Char('/') + QString::fromLatin1(hash);
+}
+
+QUrl SnapshotsManager::normalizeUrl(const QUrl &url)
+{
+	return url.adjusted(QUrl::RemoveFragment);
+}
+
+QByteArray SnapshotsManager::getData(const SnapshotResource &resource)
+{
+	QFile file(getObjectPath(resource.hash));
+
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		return QByteArray();
+	}
+
+	return qUncompress(file.readAll());
+}
+
+QVariantHash SnapshotsManager::getStatistics()
+{
+	qint64 size = 0;
+	QHash<QUrl, SnapshotResource>::const_iterator iterator;
+
+	for (iterator = m_resources.constBegin(); iterator != m_resources.constEnd(); ++iterator)
+	{
+		size += iterator.value().size;
+	}
+
+	QVariantHash statistics;
+	statistics[QLatin1String("snapshots")] = m_snapshots.count();
+	statistics[QLatin1String("resources")] = m_resources.count();
+	statistics[QLatin1String("objects")] = m_references.count();
+	statistics[QLatin1String("size")] = size;
+	statistics[QLatin1String("hits")] = m_hits;
+	statistics[QLatin1String("misses")] = m_misses;
+
+	return statistics;
+}
+
+bool SnapshotsManager::getResource(const QUrl &url, SnapshotResource *resource)
+{
+	const QUrl resourceUrl = normalizeUrl(url);
+
+	if (!m_resources.contains(resourceUrl))
+	{
+		return false;
+	}
+
+	*resource = m_resources[resourceUrl];
+
+	return true;
+}
+
+bool SnapshotsManager::hasResource(const QUrl &url)
+{
+	return m_resources.contains(normalizeUrl(url));
+}
+
+bool SnapshotsManager::hasSnapshot(const QUrl &url)
+{
+	return m_snapshots.contains(normalizeUrl(url));
+}
+
+}
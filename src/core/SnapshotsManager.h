@@ -0,0 +1,96 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2013 - 2014 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_SNAPSHOTSMANAGER_H
+#define OTTER_SNAPSHOTSMANAGER_H
+
+#include <QtCore/QHash>
+#include <QtCore/QObject>
+#include <QtCore/QUrl>
+#include <QtCore/QVariant>
+#include <QtNetwork/QNetworkReply>
+
+namespace Otter
+{
+
+class NetworkAccessManager;
+
+struct SnapshotResource
+{
+	QByteArray hash;
+	QList<QNetworkReply::RawHeaderPair> headers;
+	qint64 size;
+	int status;
+
+	SnapshotResource() : size(0), status(200) {}
+};
+
+class SnapshotsManager : public QObject
+{
+	Q_OBJECT
+
+public:
+	~SnapshotsManager();
+
+	static void createInstance(QObject *parent = NULL);
+	static void createSnapshot(const QUrl &url, const QList<QUrl> &resources);
+	static void removeSnapshot(const QUrl &url);
+	static void recordLoad(bool isHit);
+	static SnapshotsManager* getInstance();
+	static QByteArray getData(const SnapshotResource &resource);
+	static QVariantHash getStatistics();
+	static bool getResource(const QUrl &url, SnapshotResource *resource);
+	static bool hasResource(const QUrl &url);
+	static bool hasSnapshot(const QUrl &url);
+
+protected:
+	void timerEvent(QTimerEvent *event);
+	void scheduleSave();
+	static void load();
+	static void save();
+	static void storeResource(const QUrl &url, const QByteArray &data, const QList<QNetworkReply::RawHeaderPair> &headers, int status);
+	static QString getPath();
+	static QString getObjectPath(const QByteArray &hash);
+	static QUrl normalizeUrl(const QUrl &url);
+	static NetworkAccessManager* getNetworkAccessManager();
+
+protected slots:
+	void resourceFetched();
+
+private:
+	explicit SnapshotsManager(QObject *parent = NULL);
+
+	int m_saveTimer;
+
+	static SnapshotsManager *m_instance;
+	static NetworkAccessManager *m_networkAccessManager;
+	static QHash<QUrl, QList<QUrl> > m_snapshots;
+	static QHash<QUrl, SnapshotResource> m_resources;
+	static QHash<QByteArray, int> m_references;
+	static int m_hits;
+	static int m_misses;
+
+signals:
+	void snapshotCreated(const QUrl &url);
+	void snapshotRemoved(const QUrl &url);
+};
+
+}
+
+#endif
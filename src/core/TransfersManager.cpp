@@ -35,6 +35,10 @@ namespace Otter
 TransfersManager* TransfersManager::m_instance = NULL;
 NetworkAccessManager* TransfersManager::m_networkAccessManager = NULL;
 QHash<QNetworkReply*, TransferInformation*> TransfersManager::m_replies;
+QHash<TransferInformation*, QNetworkReply*> TransfersManager::m_transferReplies;
+QMultiHash<QString, TransferInformation*> TransfersManager::m_sources;
+QMultiHash<QString, TransferInformation*> TransfersManager::m_targets;
+QSet<TransferInformation*> TransfersManager::m_transfersSet;
 QList<TransferInformation*> TransfersManager::m_transfers;
 
 TransfersManager::TransfersManager(QObject *parent) : QObject(parent),
@@ -54,7 +58,7 @@ TransfersManager::TransfersManager(QObject *parent) : QObject(parent),
 		transfer->bytesReceived = history.value(QString("%1/bytesReceived").arg(entries.at(i))).toLongLong();
 		transfer->state = ((transfer->bytesReceived > 0 && transfer->bytesTotal == transfer->bytesReceived) ? FinishedTransfer : ErrorTransfer);
 
-		m_transfers.append(transfer);
+		addTransfer(transfer);
 	}
 
 	connect(QCoreApplication::instance(), SIGNAL(aboutToQuit()), this, SLOT(save()));
@@ -66,6 +70,12 @@ TransfersManager::~TransfersManager()
 	{
 		delete m_transfers.takeAt(i);
 	}
+
+	m_replies.clear();
+	m_transferReplies.clear();
+	m_sources.clear();
+	m_targets.clear();
+	m_transfersSet.clear();
 }
 
 void TransfersManager::createInstance(QObject *parent)
@@ -105,18 +115,65 @@ void TransfersManager::startUpdates()
 	}
 }
 
+void TransfersManager::addTransfer(TransferInformation *transfer)
+{
+	m_transfers.append(transfer);
+	m_transfersSet.insert(transfer);
+
+	if (!transfer->source.isEmpty())
+	{
+		m_sources.insert(transfer->source, transfer);
+	}
+
+	if (!transfer->target.isEmpty())
+	{
+		m_targets.insert(transfer->target, transfer);
+	}
+}
+
+void TransfersManager::addReply(QNetworkReply *reply, TransferInformation *transfer)
+{
+	m_replies[reply] = transfer;
+	m_transferReplies[transfer] = reply;
+}
+
+void TransfersManager::removeReply(QNetworkReply *reply)
+{
+	TransferInformation *transfer = m_replies.take(reply);
+
+	if (transfer && m_transferReplies.value(transfer) == reply)
+	{
+		m_transferReplies.remove(transfer);
+	}
+}
+
+void TransfersManager::setTarget(TransferInformation *transfer, const QString &target)
+{
+	if (!transfer->target.isEmpty())
+	{
+		m_targets.remove(transfer->target, transfer);
+	}
+
+	transfer->target = target;
+
+	if (!target.isEmpty() && m_transfersSet.contains(transfer))
+	{
+		m_targets.insert(target, transfer);
+	}
+}
+
 void TransfersManager::downloadProgress(qint64 bytesReceived, qint64 bytesTotal)
 {
-	QNetworkReply *reply = qobject_cast<QNetworkReply*>(sender());
+	TransferInformation *transfer = m_replies.value(qobject_cast<QNetworkReply*>(sender()));
 
-	if (!reply || !m_replies.contains(reply))
+	if (!transfer)
 	{
 		return;
 	}
 
-	m_replies[reply]->bytesReceivedDifference += (bytesReceived - (m_replies[reply]->bytesReceived - m_replies[reply]->bytesStart));
-	m_replies[reply]->bytesReceived = (m_replies[reply]->bytesStart + bytesReceived);
-	m_replies[reply]->bytesTotal = (m_replies[reply]->bytesStart + bytesTotal);
+	transfer->bytesReceivedDifference += (bytesReceived - (transfer->bytesReceived - transfer->bytesStart));
+	transfer->bytesReceived = (transfer->bytesStart + bytesReceived);
+	transfer->bytesTotal = (transfer->bytesStart + bytesTotal);
 }
 
 void TransfersManager::downloadData(QNetworkReply *reply)
@@ -192,7 +249,7 @@ void TransfersManager::downloadFinished(QNetworkReply *reply)
 		transfer->device->deleteLater();
 		transfer->device = NULL;
 
-		m_replies.remove(reply);
+		removeReply(reply);
 
 		QTimer::singleShot(250, reply, SLOT(deleteLater()));
 	}
@@ -250,12 +307,44 @@ void TransfersManager::save()
 
 void TransfersManager::clearTransfers(int period)
 {
+	const QDateTime currentDateTime = QDateTime::currentDateTime();
+	QList<TransferInformation*> transfers;
+	transfers.reserve(m_transfers.count());
+
 	for (int i = 0; i < m_transfers.count(); ++i)
 	{
-		if (m_transfers.at(i)->state == FinishedTransfer && (period == 0 || (m_transfers.at(i)->finished.isValid() && m_transfers.at(i)->finished.secsTo(QDateTime::currentDateTime()) > (period * 3600))))
+		TransferInformation *transfer = m_transfers.at(i);
+
+		if (transfer->state == FinishedTransfer && (period == 0 || (transfer->finished.isValid() && transfer->finished.secsTo(currentDateTime) > (period * 3600))))
+		{
+			discardTransfer(transfer, true);
+		}
+		else
+		{
+			transfers.append(transfer);
+		}
+	}
+
+	m_transfers = transfers;
+}
+
+void TransfersManager::retryTransfers(const QUrl &url)
+{
+	const QList<TransferInformation*> transfers = m_sources.values(url.toString(QUrl::RemovePassword | QUrl::PreferLocalFile));
+
+	for (int i = 0; i < transfers.count(); ++i)
+	{
+		if (transfers.at(i)->state != ErrorTransfer || m_transferReplies.contains(transfers.at(i)))
 		{
-			TransfersManager::removeTransfer(m_transfers.at(i));
+			continue;
 		}
+
+		if (transfers.at(i)->bytesReceived > 0 && resumeTransfer(transfers.at(i)))
+		{
+			continue;
+		}
+
+		restartTransfer(transfers.at(i));
 	}
 }
 
@@ -275,13 +364,10 @@ TransferInformation* TransfersManager::startTransfer(const QString &source, cons
 
 TransferInformation* TransfersManager::startTransfer(const QNetworkRequest &request, const QString &target, bool privateTransfer, bool quickTransfer)
 {
-	if (!m_networkAccessManager)
-	{
-		m_networkAccessManager = new NetworkAccessManager(true, true, NULL);
-		m_networkAccessManager->setParent(m_instance);
-	}
+	QNetworkRequest mutableRequest(request);
+	mutableRequest.setPriority(QNetworkRequest::LowPriority);
 
-	return startTransfer(m_networkAccessManager->get(request), target, privateTransfer, quickTransfer);
+	return startTransfer(getNetworkAccessManager()->get(mutableRequest), target, privateTransfer, quickTransfer);
 }
 
 TransferInformation* TransfersManager::startTransfer(QNetworkReply *reply, const QString &target, bool privateTransfer, bool quickTransfer)
@@ -310,11 +396,11 @@ TransferInformation* TransfersManager::startTransfer(QNetworkReply *reply, const
 
 	m_instance->downloadData(reply);
 
-	m_transfers.append(transfer);
+	addTransfer(transfer);
 
 	if (transfer->state == RunningTransfer)
 	{
-		m_replies[reply] = transfer;
+		addReply(reply, transfer);
 
 		connect(reply, SIGNAL(downloadProgress(qint64,qint64)), m_instance, SLOT(downloadProgress(qint64,qint64)));
 		connect(reply, SIGNAL(readyRead()), m_instance, SLOT(downloadData()));
@@ -423,7 +509,7 @@ TransferInformation* TransfersManager::startTransfer(QNetworkReply *reply, const
 		{
 			transfer->device = NULL;
 
-			m_replies.remove(reply);
+			removeReply(reply);
 
 			removeTransfer(transfer, false);
 
@@ -437,11 +523,11 @@ TransferInformation* TransfersManager::startTransfer(QNetworkReply *reply, const
 
 		SettingsManager::setValue(QLatin1String("Paths/SaveFile"), QFileInfo(path).dir().canonicalPath());
 
-		transfer->target = path;
+		setTarget(transfer, path);
 	}
 	else
 	{
-		transfer->target = QFileInfo(target).canonicalFilePath();
+		setTarget(transfer, QFileInfo(target).canonicalFilePath());
 	}
 
 	if (!target.isEmpty() && QFile::exists(transfer->target) && QMessageBox::question(SessionsManager::getActiveWindow(), tr("Question"), tr("File with the same name already exists.\nDo you want to overwrite it?\n\n%1").arg(transfer->target), (QMessageBox::Yes | QMessageBox::Cancel)) == QMessageBox::Cancel)
@@ -468,7 +554,7 @@ TransferInformation* TransfersManager::startTransfer(QNetworkReply *reply, const
 		}
 		else
 		{
-			m_replies.remove(reply);
+			removeReply(reply);
 		}
 	}
 
@@ -530,6 +616,20 @@ TransferInformation* TransfersManager::startTransfer(QNetworkReply *reply, const
 	return transfer;
 }
 
+NetworkAccessManager* TransfersManager::getNetworkAccessManager()
+{
+	if (!m_networkAccessManager)
+	{
+		m_networkAccessManager = new NetworkAccessManager(true, true, NULL);
+		m_networkAccessManager->setRequestClass(NetworkAccessManager::TransferRequestClass);
+		m_networkAccessManager->setParent(m_instance);
+
+		connect(m_networkAccessManager, SIGNAL(retryRequired(QUrl)), m_instance, SLOT(retryTransfers(QUrl)));
+	}
+
+	return m_networkAccessManager;
+}
+
 QList<TransferInformation*> TransfersManager::getTransfers()
 {
 	return m_transfers;
@@ -537,7 +637,7 @@ QList<TransferInformation*> TransfersManager::getTransfers()
 
 bool TransfersManager::resumeTransfer(TransferInformation *transfer)
 {
-	if (!m_transfers.contains(transfer) || m_replies.key(transfer) || transfer->state != ErrorTransfer || !QFile::exists(transfer->target))
+	if (!m_transfersSet.contains(transfer) || m_transferReplies.contains(transfer) || transfer->state != ErrorTransfer || !QFile::exists(transfer->target))
 	{
 		return false;
 	}
@@ -555,18 +655,13 @@ bool TransfersManager::resumeTransfer(TransferInformation *transfer)
 
 	QNetworkRequest request;
 	request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::AlwaysNetwork);
+	request.setPriority(QNetworkRequest::LowPriority);
 	request.setUrl(QUrl(transfer->source));
 	request.setRawHeader("Range", "bytes=" + QByteArray::number(file->size()) + '-');
 
-	if (!m_networkAccessManager)
-	{
-		m_networkAccessManager = new NetworkAccessManager(true, true, NULL);
-		m_networkAccessManager->setParent(m_instance);
-	}
+	QNetworkReply *reply = getNetworkAccessManager()->get(request);
 
-	QNetworkReply *reply = m_networkAccessManager->get(request);
-
-	m_replies[reply] = transfer;
+	addReply(reply, transfer);
 
 	m_instance->downloadData(reply);
 
@@ -582,7 +677,7 @@ bool TransfersManager::resumeTransfer(TransferInformation *transfer)
 
 bool TransfersManager::restartTransfer(TransferInformation *transfer)
 {
-	if (!transfer || !m_transfers.contains(transfer))
+	if (!transfer || !m_transfersSet.contains(transfer))
 	{
 		return false;
 	}
@@ -602,17 +697,12 @@ bool TransfersManager::restartTransfer(TransferInformation *transfer)
 
 	QNetworkRequest request;
 	request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::AlwaysNetwork);
+	request.setPriority(QNetworkRequest::LowPriority);
 	request.setUrl(QUrl(transfer->source));
 
-	if (!m_networkAccessManager)
-	{
-		m_networkAccessManager = new NetworkAccessManager(true, true, NULL);
-		m_networkAccessManager->setParent(m_instance);
-	}
+	QNetworkReply *reply = getNetworkAccessManager()->get(request);
 
-	QNetworkReply *reply = m_networkAccessManager->get(request);
-
-	m_replies[reply] = transfer;
+	addReply(reply, transfer);
 
 	m_instance->downloadData(reply);
 
@@ -628,11 +718,18 @@ bool TransfersManager::restartTransfer(TransferInformation *transfer)
 
 bool TransfersManager::removeTransfer(TransferInformation *transfer, bool keepFile)
 {
-	if (!transfer || !m_transfers.contains(transfer))
+	if (!transfer || !m_transfersSet.contains(transfer))
 	{
 		return false;
 	}
 
+	m_transfers.removeOne(transfer);
+
+	return discardTransfer(transfer, keepFile);
+}
+
+bool TransfersManager::discardTransfer(TransferInformation *transfer, bool keepFile)
+{
 	stopTransfer(transfer);
 
 	if (!keepFile && !transfer->target.isEmpty() && QFile::exists(transfer->target))
@@ -640,7 +737,17 @@ bool TransfersManager::removeTransfer(TransferInformation *transfer, bool keepFi
 		QFile::remove(transfer->target);
 	}
 
-	m_transfers.removeAll(transfer);
+	m_transfersSet.remove(transfer);
+
+	if (!transfer->source.isEmpty())
+	{
+		m_sources.remove(transfer->source, transfer);
+	}
+
+	if (!transfer->target.isEmpty())
+	{
+		m_targets.remove(transfer->target, transfer);
+	}
 
 	emit m_instance->transferRemoved(transfer);
 
@@ -651,7 +758,7 @@ bool TransfersManager::removeTransfer(TransferInformation *transfer, bool keepFi
 
 bool TransfersManager::stopTransfer(TransferInformation *transfer)
 {
-	QNetworkReply *reply = m_replies.key(transfer);
+	QNetworkReply *reply = m_transferReplies.value(transfer);
 
 	if (reply)
 	{
@@ -659,7 +766,7 @@ bool TransfersManager::stopTransfer(TransferInformation *transfer)
 
 		QTimer::singleShot(250, reply, SLOT(deleteLater()));
 
-		m_replies.remove(reply);
+		removeReply(reply);
 	}
 
 	if (transfer->device)
@@ -685,24 +792,11 @@ bool TransfersManager::isDownloading(const QString &source, const QString &targe
 		return false;
 	}
 
-	for (int i = 0; i < m_transfers.count(); ++i)
-	{
-		if (m_transfers.at(i)->state != RunningTransfer)
-		{
-			continue;
-		}
-
-		if (source.isEmpty() && m_transfers.at(i)->target == target)
-		{
-			return true;
-		}
-
-		if (target.isEmpty() && m_transfers.at(i)->source == source)
-		{
-			return true;
-		}
+	const QList<TransferInformation*> transfers = (source.isEmpty() ? m_targets.values(target) : m_sources.values(source));
 
-		if (!source.isEmpty() && !target.isEmpty() && m_transfers.at(i)->source == source && m_transfers.at(i)->target == target)
+	for (int i = 0; i < transfers.count(); ++i)
+	{
+		if (transfers.at(i)->state == RunningTransfer && (target.isEmpty() || source.isEmpty() || transfers.at(i)->target == target))
 		{
 			return true;
 		}
@@ -24,6 +24,7 @@
 
 #include <QtCore/QDateTime>
 #include <QtCore/QFile>
+#include <QtCore/QSet>
 #include <QtNetwork/QNetworkReply>
 #include <QtNetwork/QNetworkRequest>
 
@@ -79,12 +80,19 @@ public:
 protected:
 	void timerEvent(QTimerEvent *event);
 	void startUpdates();
+	static void addTransfer(TransferInformation *transfer);
+	static void addReply(QNetworkReply *reply, TransferInformation *transfer);
+	static void removeReply(QNetworkReply *reply);
+	static void setTarget(TransferInformation *transfer, const QString &target);
+	static NetworkAccessManager* getNetworkAccessManager();
+	static bool discardTransfer(TransferInformation *transfer, bool keepFile);
 
 protected slots:
 	void downloadProgress(qint64 bytesReceived, qint64 bytesTotal);
 	void downloadData(QNetworkReply *reply = NULL);
 	void downloadFinished(QNetworkReply *reply = NULL);
 	void downloadError(QNetworkReply::NetworkError error);
+	void retryTransfers(const QUrl &url);
 	void save();
 
 private:
@@ -95,6 +103,10 @@ private:
 	static TransfersManager *m_instance;
 	static NetworkAccessManager *m_networkAccessManager;
 	static QHash<QNetworkReply*, TransferInformation*> m_replies;
+	static QHash<TransferInformation*, QNetworkReply*> m_transferReplies;
+	static QMultiHash<QString, TransferInformation*> m_sources;
+	static QMultiHash<QString, TransferInformation*> m_targets;
+	static QSet<TransferInformation*> m_transfersSet;
 	static QList<TransferInformation*> m_transfers;
 
 signals:
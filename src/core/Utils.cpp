@@ -74,6 +74,16 @@ QString formatUnit(qint64 value, bool isSpeed, int precision)
 	return QCoreApplication::translate("utils", (isSpeed ? "%1 B/s" : "%1 B")).arg(value);
 }
 
+QString getNormalizedUrl(const QUrl &url, bool keepFragment)
+{
+	if (!url.isValid())
+	{
+		return QString();
+	}
+
+	return url.toString(keepFragment ? (QUrl::RemovePassword | QUrl::NormalizePathSegments) : (QUrl::RemovePassword | QUrl::RemoveFragment | QUrl::NormalizePathSegments));
+}
+
 QIcon getIcon(const QLatin1String &name, bool fromTheme)
 {
 	const QIcon icon(QString(":/icons/%1.png").arg(name));
@@ -81,6 +91,27 @@ QIcon getIcon(const QLatin1String &name, bool fromTheme)
 	return (fromTheme ? QIcon::fromTheme(name, icon) : icon);
 }
 
+quint64 getFingerprint(const QString &text)
+{
+	const ushort *data = text.utf16();
+	quint64 hash = Q_UINT64_C(14695981039346656037);
+
+	for (int i = 0; i < text.length(); ++i)
+	{
+		hash ^= data[i];
+		hash *= Q_UINT64_C(1099511628211);
+	}
+
+	return hash;
+}
+
+quint64 getUrlFingerprint(const QUrl &url, bool keepFragment)
+{
+	const QString normalizedUrl = getNormalizedUrl(url, keepFragment);
+
+	return (normalizedUrl.isEmpty() ? 0 : getFingerprint(normalizedUrl));
+}
+
 }
 
 }
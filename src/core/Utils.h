@@ -21,6 +21,7 @@
 #define OTTER_UTILS_H
 
 #include <QtCore/QString>
+#include <QtCore/QUrl>
 #include <QtGui/QIcon>
 
 namespace Otter
@@ -31,7 +32,10 @@ namespace Utils
 
 QString formatTime(int value);
 QString formatUnit(qint64 value, bool isSpeed = false, int precision = 1);
+QString getNormalizedUrl(const QUrl &url, bool keepFragment = false);
 QIcon getIcon(const QLatin1String &name, bool fromTheme = true);
+quint64 getFingerprint(const QString &text);
+quint64 getUrlFingerprint(const QUrl &url, bool keepFragment = false);
 
 }
 
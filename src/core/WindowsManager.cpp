@@ -19,12 +19,15 @@
 
 #include "WindowsManager.h"
 #include "Application.h"
+#include "NetworkAccessManager.h"
 #include "SettingsManager.h"
+#include "../modules/windows/web/WebContentsWidget.h"
 #include "../ui/ContentsWidget.h"
 #include "../ui/MainWindow.h"
 #include "../ui/StatusBarWidget.h"
 #include "../ui/TabBarWidget.h"
 
+#include <QtCore/QDateTime>
 #include <QtGui/QPainter>
 #include <QtPrintSupport/QPrintDialog>
 #include <QtPrintSupport/QPrintPreviewDialog>
@@ -40,6 +43,8 @@ WindowsManager::WindowsManager(QMdiArea *area, TabBarWidget *tabBar, StatusBarWi
 	m_statusBar(statusBar),
 	m_currentWindow(-1),
 	m_printedWindow(-1),
+	m_suspendTimer(0),
+	m_isRestoring(false),
 	m_privateSession(privateSession)
 {
 	connect(SessionsManager::getInstance(), SIGNAL(requestedRemoveStoredUrl(QString)), this, SLOT(removeStoredUrl(QString)));
@@ -49,6 +54,19 @@ WindowsManager::WindowsManager(QMdiArea *area, TabBarWidget *tabBar, StatusBarWi
 	connect(m_tabBar, SIGNAL(requestedPin(int,bool)), this, SLOT(pinWindow(int,bool)));
 	connect(m_tabBar, SIGNAL(requestedClose(int)), this, SLOT(closeWindow(int)));
 	connect(m_tabBar, SIGNAL(requestedCloseOther(int)), this, SLOT(closeOther(int)));
+	connect(m_tabBar, SIGNAL(tabMoved(int,int)), this, SLOT(recordWindowMoved(int,int)));
+	connect(this, SIGNAL(windowAdded(int)), this, SLOT(recordWindowAdded(int)));
+	connect(this, SIGNAL(currentWindowChanged(int)), this, SLOT(recordCurrentWindow(int)));
+
+	m_suspendTimer = startTimer(60000);
+}
+
+void WindowsManager::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() == m_suspendTimer)
+	{
+		suspendInactiveWindows();
+	}
 }
 
 void WindowsManager::open(const QUrl &url, bool privateWindow, bool background, bool newWindow)
@@ -158,21 +176,43 @@ void WindowsManager::closeOther(int index)
 	}
 }
 
-void WindowsManager::restore(const QList<SessionWindow> &windows)
+void WindowsManager::restore(const SessionEntry &session)
 {
-	if (windows.isEmpty())
+	if (session.windows.isEmpty())
 	{
 		open();
 
 		return;
 	}
 
-	m_closedWindows = windows;
+	m_closedWindows = session.windows;
+	m_isRestoring = true;
 
-	for (int i = 0; i < windows.count(); ++i)
+	for (int i = 0; i < session.windows.count(); ++i)
 	{
 		restore(0);
 	}
+
+	m_isRestoring = false;
+
+	if (!m_privateSession)
+	{
+		SessionsManager::recordSessionEvent(this, UpdateSessionRecord);
+	}
+
+	setCurrentWindow(session.index);
+
+	for (int i = 0; i < m_tabBar->count(); ++i)
+	{
+		Window *window = getWindow(i);
+
+		if (window && window->getContentsWidget()->isSuspended())
+		{
+			m_backgroundRestoreQueue.append(window);
+		}
+	}
+
+	restoreBackgroundWindows();
 }
 
 void WindowsManager::restore(int index)
@@ -190,7 +230,7 @@ void WindowsManager::restore(int index)
 	history.index = entry.index;
 	history.entries = entry.history;
 
-	Window *window = new Window(m_privateSession, NULL, m_area);
+	Window *window = new Window(m_privateSession, new WebContentsWidget(m_privateSession, NULL, NULL, true), m_area);
 	window->setUrl(entry.url());
 	window->getContentsWidget()->setHistory(history);
 	window->setSearchEngine(entry.searchEngine);
@@ -205,6 +245,50 @@ void WindowsManager::restore(int index)
 	addWindow(window);
 }
 
+void WindowsManager::suspendInactiveWindows()
+{
+	const qint64 limit = (SettingsManager::getValue(QLatin1String("Tabs/SuspendMemoryLimit")).toLongLong() * 1024);
+
+	if (limit <= 0)
+	{
+		return;
+	}
+
+	QMultiMap<qint64, Window*> windows;
+	QHash<Window*, qint64> windowsUsage;
+	qint64 usage = 0;
+
+	for (int i = 0; i < m_tabBar->count(); ++i)
+	{
+		Window *window = getWindow(i);
+
+		if (!window || window->getContentsWidget()->isSuspended())
+		{
+			continue;
+		}
+
+		const qint64 windowUsage = window->getContentsWidget()->getMemoryUsage();
+
+		usage += windowUsage;
+
+		if (i != getCurrentWindow() && !window->isLoading() && !window->isPinned())
+		{
+			windowsUsage[window] = windowUsage;
+
+			windows.insert(m_activationTimes.value(window, 0), window);
+		}
+	}
+
+	QMultiMap<qint64, Window*>::const_iterator iterator;
+
+	for (iterator = windows.constBegin(); iterator != windows.constEnd() && usage > limit; ++iterator)
+	{
+		usage -= windowsUsage.value(iterator.value(), 0);
+
+		iterator.value()->getContentsWidget()->suspend();
+	}
+}
+
 void WindowsManager::print(int index)
 {
 	Window *window = getWindow(index);
@@ -320,6 +404,7 @@ void WindowsManager::addWindow(Window *window, bool background)
 	connect(window, SIGNAL(titleChanged(QString)), this, SLOT(setTitle(QString)));
 	connect(window, SIGNAL(iconChanged(QIcon)), m_tabBar, SLOT(updateTabs()));
 	connect(window, SIGNAL(loadingChanged(bool)), m_tabBar, SLOT(updateTabs()));
+	connect(window, SIGNAL(loadingChanged(bool)), this, SLOT(recordWindowLoaded(bool)));
 	connect(m_tabBar->tabButton(index, QTabBar::LeftSide), SIGNAL(destroyed()), window, SLOT(deleteLater()));
 
 	emit windowAdded(index);
@@ -365,6 +450,8 @@ void WindowsManager::detachWindow(int index)
 
 		mainWindow->getWindowsManager()->addWindow(window->getContentsWidget(), true);
 
+		m_activationTimes.remove(window);
+
 		m_tabBar->removeTab(index);
 
 		emit windowRemoved(index);
@@ -392,6 +479,8 @@ void WindowsManager::pinWindow(int index, bool pin)
 		m_tabBar->moveTab(index, offset);
 		m_tabBar->updateTabs();
 
+		recordSessionEvent(UpdateWindowRecord, offset);
+
 		return;
 	}
 
@@ -399,6 +488,8 @@ void WindowsManager::pinWindow(int index, bool pin)
 	m_tabBar->setTabText(index, QString());
 	m_tabBar->moveTab(index, offset);
 	m_tabBar->updateTabs();
+
+	recordSessionEvent(UpdateWindowRecord, offset);
 }
 
 void WindowsManager::closeWindow(int index)
@@ -427,13 +518,7 @@ void WindowsManager::closeWindow(Window *window)
 
 	if (window && !window->isPrivate())
 	{
-		const WindowHistoryInformation history = window->getContentsWidget()->getHistory();
-		SessionWindow information;
-		information.searchEngine = window->getSearchEngine();
-		information.history = history.entries;
-		information.group = 0;
-		information.index = history.index;
-		information.pinned = window->isPinned();
+		const SessionWindow information = getSessionWindow(window);
 
 		if (window->getType() != QLatin1String("web"))
 		{
@@ -463,6 +548,10 @@ void WindowsManager::closeWindow(Window *window)
 		--m_currentWindow;
 	}
 
+	recordSessionEvent(CloseWindowRecord, index);
+
+	m_activationTimes.remove(window);
+
 	m_tabBar->removeTab(index);
 
 	emit windowRemoved(index);
@@ -491,6 +580,125 @@ void WindowsManager::removeStoredUrl(const QString &url)
 	}
 }
 
+void WindowsManager::recordWindowAdded(int index)
+{
+	recordSessionEvent(OpenWindowRecord, index);
+}
+
+void WindowsManager::recordWindowMoved(int from, int to)
+{
+	recordSessionEvent(MoveWindowRecord, from, to);
+}
+
+void WindowsManager::recordWindowLoaded(bool loading)
+{
+	if (!loading)
+	{
+		recordSessionEvent(UpdateWindowRecord, getWindowIndex(qobject_cast<Window*>(sender())));
+	}
+}
+
+void WindowsManager::recordCurrentWindow(int index)
+{
+	recordSessionEvent(ActivateWindowRecord, index);
+}
+
+void WindowsManager::recordSessionEvent(SessionRecord record, int index, int target)
+{
+	if (m_privateSession || m_isRestoring || index < 0)
+	{
+		return;
+	}
+
+	if (record == MoveWindowRecord)
+	{
+		Window *window = getWindow(target);
+
+		if (!window || window->isPrivate())
+		{
+			return;
+		}
+
+		int position = 0;
+		int from = 0;
+
+		for (int i = 0; i < m_tabBar->count() && position < index; ++i)
+		{
+			if (i == target)
+			{
+				continue;
+			}
+
+			window = getWindow(i);
+
+			if (window && !window->isPrivate())
+			{
+				++from;
+			}
+
+			++position;
+		}
+
+		SessionsManager::recordSessionEvent(this, record, from, getSessionIndex(target));
+
+		return;
+	}
+
+	if (record == ActivateWindowRecord)
+	{
+		SessionsManager::recordSessionEvent(this, record, getSessionIndex(index));
+
+		return;
+	}
+
+	Window *window = getWindow(index);
+
+	if (window && !window->isPrivate())
+	{
+		SessionsManager::recordSessionEvent(this, record, getSessionIndex(index), -1, ((record == CloseWindowRecord) ? SessionWindow() : getSessionWindow(window)));
+	}
+}
+
+void WindowsManager::restoreBackgroundWindows()
+{
+	Window *window = qobject_cast<Window*>(sender());
+
+	if (window)
+	{
+		if (window->isLoading())
+		{
+			return;
+		}
+
+		disconnect(window, SIGNAL(loadingChanged(bool)), this, SLOT(restoreBackgroundWindows()));
+
+		m_backgroundRestores.removeAll(window);
+	}
+
+	m_backgroundRestores.removeAll(QPointer<Window>());
+
+	const int limit = SettingsManager::getValue(QLatin1String("Tabs/BackgroundRestoreLimit")).toInt();
+
+	while (m_backgroundRestores.count() < limit && !m_backgroundRestoreQueue.isEmpty())
+	{
+		const QPointer<Window> queuedWindow = m_backgroundRestoreQueue.takeFirst();
+
+		if (!queuedWindow || !queuedWindow->getContentsWidget()->isSuspended())
+		{
+			continue;
+		}
+
+		if (!queuedWindow->getContentsWidget()->getHistory().entries.isEmpty())
+		{
+			m_backgroundRestores.append(queuedWindow);
+
+			connect(queuedWindow, SIGNAL(loadingChanged(bool)), this, SLOT(restoreBackgroundWindows()));
+		}
+
+		queuedWindow->getContentsWidget()->resume();
+	}
+}
+
 void WindowsManager::setDefaultTextEncoding(const QString &encoding)
 {
 	Window *window = getWindow(getCurrentWindow());
@@ -525,10 +733,13 @@ void WindowsManager::setCurrentWindow(int index)
 		return;
 	}
 
+	const qint64 currentTime = QDateTime::currentMSecsSinceEpoch();
 	Window *window = getWindow(m_currentWindow);
 
 	if (window)
 	{
+		m_activationTimes[window] = currentTime;
+
 		if (window->parentWidget())
 		{
 			window->parentWidget()->showMinimized();
@@ -558,6 +769,15 @@ void WindowsManager::setCurrentWindow(int index)
 
 	if (window)
 	{
+		m_activationTimes[window] = currentTime;
+
+		if (!m_isRestoring)
+		{
+			window->getContentsWidget()->resume();
+		}
+
+		NetworkAccessManager::setActiveWidget(window->getContentsWidget());
+
 		if (window->parentWidget())
 		{
 			window->parentWidget()->showMaximized();
@@ -664,15 +884,7 @@ SessionEntry WindowsManager::getSession() const
 
 		if (window && !window->isPrivate())
 		{
-			const WindowHistoryInformation history = window->getContentsWidget()->getHistory();
-			SessionWindow information;
-			information.searchEngine = window->getSearchEngine();
-			information.history = history.entries;
-			information.group = 0;
-			information.index = history.index;
-			information.pinned = window->isPinned();
-
-			session.windows.append(information);
+			session.windows.append(getSessionWindow(window));
 		}
 		else if (i < session.index)
 		{
@@ -683,11 +895,41 @@ SessionEntry WindowsManager::getSession() const
 	return session;
 }
 
+SessionWindow WindowsManager::getSessionWindow(Window *window) const
+{
+	const WindowHistoryInformation history = window->getContentsWidget()->getHistory();
+	SessionWindow information;
+	information.searchEngine = window->getSearchEngine();
+	information.history = history.entries;
+	information.group = 0;
+	information.index = history.index;
+	information.pinned = window->isPinned();
+
+	return information;
+}
+
 QList<SessionWindow> WindowsManager::getClosedWindows() const
 {
 	return m_closedWindows;
 }
 
+int WindowsManager::getSessionIndex(int index) const
+{
+	int sessionIndex = 0;
+
+	for (int i = 0; i < index; ++i)
+	{
+		Window *window = getWindow(i);
+
+		if (window && !window->isPrivate())
+		{
+			++sessionIndex;
+		}
+	}
+
+	return sessionIndex;
+}
+
 int WindowsManager::getWindowIndex(Window *window) const
 {
 	for (int i = 0; i < m_tabBar->count(); ++i)
@@ -23,6 +23,7 @@
 #include "SessionsManager.h"
 #include "../ui/Window.h"
 
+#include <QtCore/QPointer>
 #include <QtCore/QUrl>
 #include <QtPrintSupport/QPrinter>
 #include <QtWidgets/QMdiArea>
@@ -61,7 +62,7 @@ public slots:
 	void closeAll();
 	void closeOther(int index = -1);
 	void restore(int index = 0);
-	void restore(const QList<SessionWindow> &windows);
+	void restore(const SessionEntry &session);
 	void print(int index = -1);
 	void printPreview(int index = -1);
 	void triggerAction(WindowAction action, bool checked = false);
@@ -71,6 +72,11 @@ public slots:
 	void setZoom(int zoom);
 
 protected:
+	void timerEvent(QTimerEvent *event);
+	void suspendInactiveWindows();
+	void recordSessionEvent(SessionRecord record, int index, int target = -1);
+	SessionWindow getSessionWindow(Window *window) const;
+	int getSessionIndex(int index) const;
 	int getWindowIndex(Window *window) const;
 
 protected slots:
@@ -83,6 +89,11 @@ protected slots:
 	void closeWindow(int index);
 	void closeWindow(Window *window);
 	void removeStoredUrl(const QString &url);
+	void recordWindowAdded(int index);
+	void recordWindowMoved(int from, int to);
+	void recordWindowLoaded(bool loading);
+	void recordCurrentWindow(int index);
+	void restoreBackgroundWindows();
 	void setTitle(const QString &title);
 
 private:
@@ -90,8 +101,13 @@ private:
 	TabBarWidget *m_tabBar;
 	StatusBarWidget *m_statusBar;
 	QList<SessionWindow> m_closedWindows;
+	QList<QPointer<Window> > m_backgroundRestoreQueue;
+	QList<QPointer<Window> > m_backgroundRestores;
+	QHash<Window*, qint64> m_activationTimes;
 	int m_currentWindow;
 	int m_printedWindow;
+	int m_suspendTimer;
+	bool m_isRestoring;
 	bool m_privateSession;
 
 signals:
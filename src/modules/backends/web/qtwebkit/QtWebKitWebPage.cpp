@@ -19,6 +19,7 @@
 
 #include "QtWebKitWebPage.h"
 #include "QtWebKitWebWidget.h"
+#include "../../../../core/ContentBlockingManager.h"
 #include "../../../../core/SettingsManager.h"
 
 #include <QtCore/QEventLoop>
@@ -37,6 +38,8 @@
 namespace Otter
 {
 
+QPointer<QtWebKitWebPage> QtWebKitWebPage::m_dialogPage;
+
 QtWebKitWebPage::QtWebKitWebPage(QtWebKitWebWidget *parent) : QWebPage(parent),
 	m_webWidget(parent),
 	m_ignoreJavaScriptPopups(false)
@@ -46,6 +49,7 @@ QtWebKitWebPage::QtWebKitWebPage(QtWebKitWebWidget *parent) : QWebPage(parent),
 
 	connect(this, SIGNAL(loadFinished(bool)), this, SLOT(clearIgnoreJavaScriptPopups()));
 	connect(SettingsManager::getInstance(), SIGNAL(valueChanged(QString,QVariant)), this, SLOT(optionChanged(QString,QVariant)));
+	connect(ContentBlockingManager::getInstance(), SIGNAL(rulesChanged()), this, SLOT(updateStyleSheet()));
 }
 
 void QtWebKitWebPage::clearIgnoreJavaScriptPopups()
@@ -61,10 +65,15 @@ void QtWebKitWebPage::optionChanged(const QString &option, const QVariant &value
 	}
 	else if (option.startsWith(QLatin1String("Content/")))
 	{
-		settings()->setUserStyleSheetUrl(QUrl(QLatin1String("data:text/css;charset=utf-8;base64,") + QString(QString("html {background: %1; color: %2;} a {color: %3;} a:visited {color: %4;}").arg(SettingsManager::getValue(QLatin1String("Content/BackgroundColor")).toString()).arg(SettingsManager::getValue(QLatin1String("Content/TextColor")).toString()).arg(SettingsManager::getValue(QLatin1String("Content/LinkColor")).toString()).arg(SettingsManager::getValue(QLatin1String("Content/VisitedLinkColor")).toString()).toUtf8().toBase64())));
+		updateStyleSheet();
 	}
 }
 
+void QtWebKitWebPage::updateStyleSheet()
+{
+	settings()->setUserStyleSheetUrl(QUrl(QLatin1String("data:text/css;charset=utf-8;base64,") + QString((QString("html {background: %1; color: %2;} a {color: %3;} a:visited {color: %4;}\n").arg(SettingsManager::getValue(QLatin1String("Content/BackgroundColor")).toString()).arg(SettingsManager::getValue(QLatin1String("Content/TextColor")).toString()).arg(SettingsManager::getValue(QLatin1String("Content/LinkColor")).toString()).arg(SettingsManager::getValue(QLatin1String("Content/VisitedLinkColor")).toString()) + ContentBlockingManager::getStyleSheet()).toUtf8().toBase64())));
+}
+
 void QtWebKitWebPage::javaScriptAlert(QWebFrame *frame, const QString &message)
 {
 	if (m_ignoreJavaScriptPopups)
@@ -74,33 +83,65 @@ void QtWebKitWebPage::javaScriptAlert(QWebFrame *frame, const QString &message)
 
 	if (m_webWidget)
 	{
-		QMessageBox dialog;
-		dialog.setModal(false);
-		dialog.setWindowTitle(tr("JavaScript"));
-		dialog.setText(message.toHtmlEscaped());
-		dialog.setStandardButtons(QMessageBox::Ok);
-		dialog.setCheckBox(new QCheckBox(tr("Disable JavaScript popups")));
+		m_alerts.append(message);
 
-		QEventLoop eventLoop;
+		if (m_alerts.count() == 1)
+		{
+			showAlert();
+		}
 
-		m_webWidget->showDialog(&dialog);
+		return;
+	}
 
-		connect(&dialog, SIGNAL(finished(int)), &eventLoop, SLOT(quit()));
-		connect(this, SIGNAL(destroyed()), &eventLoop, SLOT(quit()));
+	QWebPage::javaScriptAlert(frame, message);
+}
 
-		eventLoop.exec();
+void QtWebKitWebPage::showAlert()
+{
+	QMessageBox *dialog = new QMessageBox(m_webWidget);
+	dialog->setModal(false);
+	dialog->setWindowTitle(tr("JavaScript"));
+	dialog->setText(m_alerts.first().toHtmlEscaped());
+	dialog->setStandardButtons(QMessageBox::Ok);
+	dialog->setCheckBox(new QCheckBox(tr("Disable JavaScript popups")));
 
-		m_webWidget->hideDialog(&dialog);
+	connect(dialog, SIGNAL(finished(int)), this, SLOT(alertFinished()));
 
-		if (dialog.checkBox()->isChecked())
-		{
-			m_ignoreJavaScriptPopups = true;
-		}
+	m_webWidget->showDialog(dialog);
+}
 
+void QtWebKitWebPage::alertFinished()
+{
+	QMessageBox *dialog = qobject_cast<QMessageBox*>(sender());
+
+	if (!dialog)
+	{
 		return;
 	}
 
-	QWebPage::javaScriptAlert(frame, message);
+	if (m_webWidget)
+	{
+		m_webWidget->hideDialog(dialog);
+	}
+
+	if (dialog->checkBox()->isChecked())
+	{
+		m_ignoreJavaScriptPopups = true;
+
+		m_alerts.clear();
+	}
+
+	dialog->deleteLater();
+
+	if (!m_alerts.isEmpty())
+	{
+		m_alerts.removeFirst();
+	}
+
+	if (!m_alerts.isEmpty() && m_webWidget)
+	{
+		showAlert();
+	}
 }
 
 void QtWebKitWebPage::triggerAction(QWebPage::WebAction action, bool checked)
@@ -168,18 +209,7 @@ bool QtWebKitWebPage::acceptNavigationRequest(QWebFrame *frame, const QNetworkRe
 		{
 			dialog.setModal(false);
 
-			QEventLoop eventLoop;
-
-			m_webWidget->showDialog(&dialog);
-
-			connect(&dialog, SIGNAL(finished(int)), &eventLoop, SLOT(quit()));
-			connect(this, SIGNAL(destroyed()), &eventLoop, SLOT(quit()));
-
-			eventLoop.exec();
-
-			m_webWidget->hideDialog(&dialog);
-
-			cancel = (dialog.buttonRole(dialog.clickedButton()) == QMessageBox::RejectRole);
+			cancel = (!runDialog(&dialog) || dialog.buttonRole(dialog.clickedButton()) == QMessageBox::RejectRole);
 		}
 		else
 		{
@@ -213,16 +243,10 @@ bool QtWebKitWebPage::javaScriptConfirm(QWebFrame *frame, const QString &message
 		dialog.setStandardButtons(QMessageBox::Ok | QMessageBox::Cancel);
 		dialog.setCheckBox(new QCheckBox(tr("Disable JavaScript popups")));
 
-		QEventLoop eventLoop;
-
-		m_webWidget->showDialog(&dialog);
-
-		connect(&dialog, SIGNAL(finished(int)), &eventLoop, SLOT(quit()));
-		connect(this, SIGNAL(destroyed()), &eventLoop, SLOT(quit()));
-
-		eventLoop.exec();
-
-		m_webWidget->hideDialog(&dialog);
+		if (!runDialog(&dialog))
+		{
+			return false;
+		}
 
 		if (dialog.checkBox()->isChecked())
 		{
@@ -251,16 +275,10 @@ bool QtWebKitWebPage::javaScriptPrompt(QWebFrame *frame, const QString &message,
 		dialog.setInputMode(QInputDialog::TextInput);
 		dialog.setTextValue(defaultValue);
 
-		QEventLoop eventLoop;
-
-		m_webWidget->showDialog(&dialog);
-
-		connect(&dialog, SIGNAL(finished(int)), &eventLoop, SLOT(quit()));
-		connect(this, SIGNAL(destroyed()), &eventLoop, SLOT(quit()));
-
-		eventLoop.exec();
-
-		m_webWidget->hideDialog(&dialog);
+		if (!runDialog(&dialog))
+		{
+			return false;
+		}
 
 		if (dialog.result() == QDialog::Accepted)
 		{
@@ -324,26 +342,60 @@ bool QtWebKitWebPage::shouldInterruptJavaScript()
 		dialog.setIcon(QMessageBox::Question);
 		dialog.setStandardButtons(QMessageBox::Yes | QMessageBox::No);
 
-		QEventLoop eventLoop;
+		if (!runDialog(&dialog))
+		{
+			return false;
+		}
 
-		m_webWidget->showDialog(&dialog);
+		return (dialog.buttonRole(dialog.clickedButton()) == QMessageBox::YesRole);
+	}
 
-		connect(&dialog, SIGNAL(finished(int)), &eventLoop, SLOT(quit()));
+	return QWebPage::shouldInterruptJavaScript();
+}
+
+bool QtWebKitWebPage::runDialog(QDialog *dialog)
+{
+	QPointer<QtWebKitWebPage> page(this);
+
+	while (m_dialogPage)
+	{
+		QEventLoop eventLoop;
+
+		connect(m_dialogPage, SIGNAL(dialogFinished()), &eventLoop, SLOT(quit()));
+		connect(m_dialogPage, SIGNAL(destroyed()), &eventLoop, SLOT(quit()));
 		connect(this, SIGNAL(destroyed()), &eventLoop, SLOT(quit()));
 
 		eventLoop.exec();
 
-		m_webWidget->hideDialog(&dialog);
+		if (!page)
+		{
+			return false;
+		}
+	}
 
-		return (dialog.buttonRole(dialog.clickedButton()) == QMessageBox::YesRole);
+	m_dialogPage = this;
+
+	QEventLoop eventLoop;
+
+	m_webWidget->showDialog(dialog);
+
+	connect(dialog, SIGNAL(finished(int)), &eventLoop, SLOT(quit()));
+	connect(this, SIGNAL(destroyed()), &eventLoop, SLOT(quit()));
+
+	eventLoop.exec();
+
+	if (!page)
+	{
+		return false;
 	}
 
-	return QWebPage::shouldInterruptJavaScript();
-}
+	m_dialogPage = NULL;
 
-bool QtWebKitWebPage::supportsExtension(QWebPage::Extension extension) const
-{
-	return (extension == QWebPage::ErrorPageExtension);
+	m_webWidget->hideDialog(dialog);
+
+	emit dialogFinished();
+
+	return true;
 }
 
 }
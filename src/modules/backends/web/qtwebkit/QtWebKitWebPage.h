@@ -20,7 +20,9 @@
 #ifndef OTTER_QTWEBKITWEBPAGE_H
 #define OTTER_QTWEBKITWEBPAGE_H
 
+#include <QtCore/QPointer>
 #include <QtWebKitWidgets/QWebPage>
+#include <QtWidgets/QDialog>
 
 namespace Otter
 {
@@ -43,21 +45,29 @@ public:
 
 protected:
 	void javaScriptAlert(QWebFrame *frame, const QString &message);
+	void showAlert();
 	QWebPage* createWindow(WebWindowType type);
 	bool acceptNavigationRequest(QWebFrame *frame, const QNetworkRequest &request, NavigationType type);
 	bool javaScriptConfirm(QWebFrame *frame, const QString &message);
 	bool javaScriptPrompt(QWebFrame *frame, const QString &message, const QString &defaultValue, QString *result);
+	bool runDialog(QDialog *dialog);
 
 protected slots:
+	void alertFinished();
 	void clearIgnoreJavaScriptPopups();
 	void optionChanged(const QString &option, const QVariant &value);
+	void updateStyleSheet();
 
 private:
 	QtWebKitWebWidget *m_webWidget;
+	QStringList m_alerts;
 	bool m_ignoreJavaScriptPopups;
 
+	static QPointer<QtWebKitWebPage> m_dialogPage;
+
 signals:
 	void requestedNewWindow(WebWidget *widget);
+	void dialogFinished();
 };
 
 }
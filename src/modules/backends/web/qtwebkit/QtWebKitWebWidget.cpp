@@ -23,9 +23,13 @@
 #include "../../../../core/ActionsManager.h"
 #include "../../../../core/HistoryManager.h"
 #include "../../../../core/NetworkAccessManager.h"
+#include "../../../../core/NetworkCache.h"
+#include "../../../../core/PreconnectManager.h"
+#include "../../../../core/PrefetchManager.h"
 #include "../../../../core/SearchesManager.h"
 #include "../../../../core/SessionsManager.h"
 #include "../../../../core/SettingsManager.h"
+#include "../../../../core/SnapshotsManager.h"
 #include "../../../../core/TransfersManager.h"
 #include "../../../../core/Utils.h"
 #include "../../../../ui/ContentsWidget.h"
@@ -84,6 +88,7 @@ QtWebKitWebWidget::QtWebKitWebWidget(bool privateWindow, ContentsWidget *parent,
 
 	m_networkAccessManager = new NetworkAccessManager(privateWindow, false, parent);
 	m_networkAccessManager->setParent(page);
+	m_networkAccessManager->setMainFrame(page->mainFrame());
 
 	page->setNetworkAccessManager(m_networkAccessManager);
 	page->setForwardUnsupportedContent(true);
@@ -128,6 +133,8 @@ QtWebKitWebWidget::QtWebKitWebWidget(bool privateWindow, ContentsWidget *parent,
 
 	connect(SearchesManager::getInstance(), SIGNAL(searchEnginesModified()), this, SLOT(updateSearchActions()));
 	connect(SettingsManager::getInstance(), SIGNAL(valueChanged(QString,QVariant)), this, SLOT(optionChanged(QString,QVariant)));
+	connect(SnapshotsManager::getInstance(), SIGNAL(snapshotCreated(QUrl)), this, SLOT(updateSnapshotAction()));
+	connect(SnapshotsManager::getInstance(), SIGNAL(snapshotRemoved(QUrl)), this, SLOT(updateSnapshotAction()));
 	connect(page, SIGNAL(requestedNewWindow(WebWidget*)), this, SIGNAL(requestedNewWindow(WebWidget*)));
 	connect(page, SIGNAL(microFocusChanged()), this, SIGNAL(actionsChanged()));
 	connect(page, SIGNAL(selectionChanged()), this, SIGNAL(actionsChanged()));
@@ -209,6 +216,8 @@ void QtWebKitWebWidget::pageLoadStarted()
 {
 	m_isLoading = true;
 
+	m_networkAccessManager->clearPageResources();
+
 	m_thumbnail = QPixmap();
 
 	if (m_actions.contains(RewindBackAction))
@@ -233,8 +242,6 @@ void QtWebKitWebWidget::pageLoadStarted()
 
 	if (!isPrivate())
 	{
-		SessionsManager::markSessionModified();
-
 		m_historyEntry = HistoryManager::addEntry(getUrl(), m_webView->title(), m_webView->icon(), m_isTyped);
 
 		m_isTyped = false;
@@ -268,21 +275,28 @@ void QtWebKitWebWidget::pageLoadFinished(bool ok)
 
 	if (!isPrivate())
 	{
-		if (ok)
+		if (ok && m_historyEntry >= 0)
 		{
-			SessionsManager::markSessionModified();
-
-			if (m_historyEntry >= 0)
-			{
-				HistoryManager::updateEntry(m_historyEntry, getUrl(), m_webView->title(), m_webView->icon());
-			}
+			HistoryManager::updateEntry(m_historyEntry, getUrl(), m_webView->title(), m_webView->icon());
 		}
 		else if (m_historyEntry >= 0)
 		{
 			HistoryManager::removeEntry(m_historyEntry);
 		}
-	}
 
+		if (ok && isVisible())
+		{
+			QList<QUrl> hints;
+			const QWebElementCollection elements = m_webView->page()->mainFrame()->findAllElements(QLatin1String("link[rel~=\"next\"][href], link[rel~=\"prefetch\"][href]"));
+
+			for (int i = 0; i < elements.count(); ++i)
+			{
+				hints.append(m_webView->page()->mainFrame()->baseUrl().resolved(QUrl(elements.at(i).attribute(QLatin1String("href")))));
+			}
+
+			PrefetchManager::prefetch(getUrl(), hints);
+		}
+	}
 
 	emit loadingChanged(false);
 }
@@ -308,6 +322,11 @@ void QtWebKitWebWidget::linkHovered(const QString &link, const QString &title)
 
 	m_isLinkHovered = !text.isEmpty();
 
+	if (m_isLinkHovered)
+	{
+		PreconnectManager::preconnect(QUrl(link), isPrivate());
+	}
+
 	QToolTip::showText(QCursor::pos(), text, m_webView);
 
 	emit statusMessageChanged(link, 0);
@@ -377,6 +396,8 @@ void QtWebKitWebWidget::notifyUrlChanged(const QUrl &url)
 		getAction(RewindForwardAction)->setEnabled(getAction(GoForwardAction)->isEnabled());
 	}
 
+	updateSnapshotAction();
+
 	emit urlChanged(url);
 }
 
@@ -385,6 +406,14 @@ void QtWebKitWebWidget::notifyIconChanged()
 	emit iconChanged(getIcon());
 }
 
+void QtWebKitWebWidget::updateSnapshotAction()
+{
+	if (m_actions.contains(SaveForOfflineAction))
+	{
+		getAction(SaveForOfflineAction)->setChecked(SnapshotsManager::hasSnapshot(getUrl()));
+	}
+}
+
 void QtWebKitWebWidget::updateSearchActions(const QString &engine)
 {
 	if (sender() == SearchesManager::getInstance())
@@ -469,6 +498,19 @@ void QtWebKitWebWidget::triggerAction(WindowAction action, bool checked)
 		case CopyAddressAction:
 			QApplication::clipboard()->setText(getUrl().toString());
 
+			break;
+		case SaveForOfflineAction:
+			if (SnapshotsManager::hasSnapshot(getUrl()))
+			{
+				SnapshotsManager::removeSnapshot(getUrl());
+			}
+			else if (!isPrivate())
+			{
+				SnapshotsManager::createSnapshot(getUrl(), m_networkAccessManager->getPageResources());
+			}
+
+			updateSnapshotAction();
+
 			break;
 		case ZoomInAction:
 			setZoom(qMin((getZoom() + 10), 10000));
@@ -534,7 +576,7 @@ void QtWebKitWebWidget::triggerAction(WindowAction action, bool checked)
 			break;
 		case ImagePropertiesAction:
 			{
-				ImagePropertiesDialog dialog(m_hitResult.imageUrl(), m_hitResult.element().attribute(QLatin1String("alt")), m_hitResult.element().attribute(QLatin1String("longdesc")), m_hitResult.pixmap(), (m_networkAccessManager->cache() ? m_networkAccessManager->cache()->data(m_hitResult.imageUrl()) : NULL), this);
+				ImagePropertiesDialog dialog(m_hitResult.imageUrl(), m_hitResult.element().attribute(QLatin1String("alt")), m_hitResult.element().attribute(QLatin1String("longdesc")), m_hitResult.pixmap(), (isPrivate() ? NULL : NetworkAccessManager::getCache()->data(m_hitResult.imageUrl())), this);
 				QEventLoop eventLoop;
 
 				m_parent->showDialog(&dialog);
@@ -799,6 +841,11 @@ void QtWebKitWebWidget::setHistory(const WindowHistoryInformation &history)
 	m_webView->page()->history()->goToItem(m_webView->page()->history()->itemAt(history.index));
 }
 
+void QtWebKitWebWidget::setLoadStatusUpdatesEnabled(bool enabled)
+{
+	m_networkAccessManager->setStatusUpdatesEnabled(enabled);
+}
+
 void QtWebKitWebWidget::setZoom(int zoom)
 {
 	if (zoom != getZoom())
@@ -1051,6 +1098,14 @@ QAction* QtWebKitWebWidget::getAction(WindowAction action)
 		case CopyAddressAction:
 			ActionsManager::setupLocalAction(actionObject, QLatin1String("CopyAddress"), true);
 
+			break;
+		case SaveForOfflineAction:
+			ActionsManager::setupLocalAction(actionObject, QLatin1String("SaveForOffline"), true);
+
+			actionObject->setCheckable(true);
+			actionObject->setChecked(SnapshotsManager::hasSnapshot(getUrl()));
+			actionObject->setEnabled(!isPrivate());
+
 			break;
 		case ViewSourceAction:
 			ActionsManager::setupLocalAction(actionObject, QLatin1String("ViewSource"), true);
@@ -1406,6 +1461,32 @@ QWebPage::WebAction QtWebKitWebWidget::mapAction(WindowAction action) const
 	return QWebPage::NoWebAction;
 }
 
+qint64 QtWebKitWebWidget::getMemoryUsage() const
+{
+	qint64 usage = m_webView->page()->totalBytes();
+	QList<QWebFrame*> frames;
+	frames.append(m_webView->page()->mainFrame());
+
+	while (!frames.isEmpty())
+	{
+		QWebFrame *frame = frames.takeFirst();
+		const QWebElementCollection elements = frame->findAllElements(QLatin1String("img, canvas"));
+
+		usage += (static_cast<qint64>(frame->geometry().width()) * frame->geometry().height() * 4);
+
+		for (int i = 0; i < elements.count(); ++i)
+		{
+			const QRect geometry = elements.at(i).geometry();
+
+			usage += (static_cast<qint64>(geometry.width()) * geometry.height() * 4);
+		}
+
+		frames.append(frame->childFrames());
+	}
+
+	return usage;
+}
+
 int QtWebKitWebWidget::getZoom() const
 {
 	return (m_webView->zoomFactor() * 100);
@@ -57,6 +57,7 @@ public:
 	QPixmap getThumbnail();
 	QRect getProgressBarGeometry() const;
 	WindowHistoryInformation getHistory() const;
+	qint64 getMemoryUsage() const;
 	int getZoom() const;
 	bool isLoading() const;
 	bool isPrivate() const;
@@ -70,6 +71,7 @@ public slots:
 	void triggerAction(WindowAction action, bool checked = false);
 	void setDefaultTextEncoding(const QString &encoding);
 	void setHistory(const WindowHistoryInformation &history);
+	void setLoadStatusUpdatesEnabled(bool enabled);
 	void setZoom(int zoom);
 	void setUrl(const QUrl &url, bool typed = true);
 
@@ -92,6 +94,7 @@ protected slots:
 	void notifyUrlChanged(const QUrl &url);
 	void notifyIconChanged();
 	void updateSearchActions(const QString &engine = QString());
+	void updateSnapshotAction();
 	void showContextMenu(const QPoint &position = QPoint());
 
 private:
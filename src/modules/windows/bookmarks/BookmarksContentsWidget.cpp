@@ -28,6 +28,7 @@
 #include "ui_BookmarksContentsWidget.h"
 
 #include <QtGui/QClipboard>
+#include <QtGui/QDropEvent>
 #include <QtWidgets/QCheckBox>
 #include <QtWidgets/QMenu>
 #include <QtWidgets/QMessageBox>
@@ -50,6 +51,7 @@ BookmarksContentsWidget::BookmarksContentsWidget(Window *window) : ContentsWidge
 
 	m_ui->bookmarksView->setModel(m_model);
 	m_ui->bookmarksView->setItemDelegate(new ItemDelegate(this));
+	m_ui->bookmarksView->viewport()->installEventFilter(this);
 
 	QMenu *addMenu = new QMenu(m_ui->addButton);
 	addMenu->addAction(Utils::getIcon(QLatin1String("inode-directory")), tr("Add Folder"), this, SLOT(addFolder()));
@@ -58,7 +60,10 @@ BookmarksContentsWidget::BookmarksContentsWidget(Window *window) : ContentsWidge
 
 	m_ui->addButton->setMenu(addMenu);
 
-	connect(BookmarksManager::getInstance(), SIGNAL(folderModified(int)), this, SLOT(updateFolder(int)));
+	connect(BookmarksManager::getInstance(), SIGNAL(bookmarkAdded(BookmarkInformation*,int,int)), this, SLOT(insertBookmark(BookmarkInformation*,int,int)));
+	connect(BookmarksManager::getInstance(), SIGNAL(bookmarkRemoved(BookmarkInformation*,int,int)), this, SLOT(takeBookmark(BookmarkInformation*,int,int)));
+	connect(BookmarksManager::getInstance(), SIGNAL(bookmarkMoved(BookmarkInformation*,int,int,int,int)), this, SLOT(moveBookmark(BookmarkInformation*,int,int,int,int)));
+	connect(BookmarksManager::getInstance(), SIGNAL(bookmarkChanged(BookmarkInformation*,int,int)), this, SLOT(updateBookmark(BookmarkInformation*,int,int)));
 	connect(m_ui->filterLineEdit, SIGNAL(textChanged(QString)), this, SLOT(filterBookmarks(QString)));
 	connect(m_ui->bookmarksView, SIGNAL(doubleClicked(QModelIndex)), this, SLOT(openBookmark(QModelIndex)));
 	connect(m_ui->bookmarksView, SIGNAL(customContextMenuRequested(QPoint)), this, SLOT(showContextMenu(QPoint)));
@@ -88,7 +93,7 @@ void BookmarksContentsWidget::changeEvent(QEvent *event)
 	}
 }
 
-void BookmarksContentsWidget::addBookmark(BookmarkInformation *bookmark, QStandardItem *parent)
+void BookmarksContentsWidget::addBookmark(BookmarkInformation *bookmark, QStandardItem *parent, int row)
 {
 	if (!bookmark)
 	{
@@ -112,6 +117,8 @@ void BookmarksContentsWidget::addBookmark(BookmarkInformation *bookmark, QStanda
 		case FolderBookmark:
 			item = new QStandardItem(Utils::getIcon(QLatin1String("inode-directory")), (bookmark->title.isEmpty() ? tr("(Untitled)") : bookmark->title));
 
+			m_folders[bookmark->identifier] = item;
+
 			for (int i = 0; i < bookmark->children.count(); ++i)
 			{
 				addBookmark(bookmark->children.at(i), item);
@@ -131,7 +138,14 @@ void BookmarksContentsWidget::addBookmark(BookmarkInformation *bookmark, QStanda
 
 	item->setData(qVariantFromValue((void*) bookmark), Qt::UserRole);
 
-	parent->appendRow(item);
+	if (row < 0 || row > parent->rowCount())
+	{
+		parent->appendRow(item);
+	}
+	else
+	{
+		parent->insertRow(row, item);
+	}
 }
 
 void BookmarksContentsWidget::addBookmark()
@@ -310,23 +324,90 @@ void BookmarksContentsWidget::gatherBookmarks(int folder)
 	}
 }
 
-void BookmarksContentsWidget::updateFolder(int folder)
+void BookmarksContentsWidget::forgetFolders(BookmarkInformation *bookmark)
+{
+	if (bookmark->type != FolderBookmark)
+	{
+		return;
+	}
+
+	m_folders.remove(bookmark->identifier);
+
+	for (int i = 0; i < bookmark->children.count(); ++i)
+	{
+		forgetFolders(bookmark->children.at(i));
+	}
+}
+
+void BookmarksContentsWidget::insertBookmark(BookmarkInformation *bookmark, int folder, int row)
 {
 	QStandardItem *item = findFolder(folder);
 
-	if (!item)
+	if (item)
+	{
+		addBookmark(bookmark, item, row);
+	}
+}
+
+void BookmarksContentsWidget::takeBookmark(BookmarkInformation *bookmark, int folder, int row)
+{
+	forgetFolders(bookmark);
+
+	QStandardItem *item = findFolder(folder);
+
+	if (item && row >= 0 && row < item->rowCount())
+	{
+		item->removeRow(row);
+	}
+}
+
+void BookmarksContentsWidget::moveBookmark(BookmarkInformation *bookmark, int previousFolder, int previousRow, int folder, int row)
+{
+	QStandardItem *previousItem = findFolder(previousFolder);
+	QStandardItem *item = findFolder(folder);
+
+	if (!previousItem || !item || previousRow < 0 || previousRow >= previousItem->rowCount())
 	{
 		return;
 	}
 
-	item->removeRows(0, item->rowCount());
+	const QList<QStandardItem*> items = previousItem->takeRow(previousRow);
 
-	const QList<BookmarkInformation*> bookmarks = BookmarksManager::getFolder(folder);
+	if (items.isEmpty() || items.first()->data(Qt::UserRole).value<void*>() != bookmark)
+	{
+		qDeleteAll(items);
 
-	for (int i = 0; i < bookmarks.count(); ++i)
+		return;
+	}
+
+	if (row < 0 || row > item->rowCount())
+	{
+		item->appendRow(items);
+	}
+	else
+	{
+		item->insertRow(row, items);
+	}
+}
+
+void BookmarksContentsWidget::updateBookmark(BookmarkInformation *bookmark, int folder, int row)
+{
+	QStandardItem *parent = findFolder(folder);
+	QStandardItem *item = ((parent && row >= 0) ? parent->child(row, 0) : NULL);
+
+	if (!item)
+	{
+		return;
+	}
+
+	item->setText(bookmark->title.isEmpty() ? tr("(Untitled)") : bookmark->title);
+
+	if (bookmark->type == UrlBookmark)
 	{
-		addBookmark(bookmarks.at(i), item);
+		item->setIcon(WebBackendsManager::getBackend()->getIconForUrl(QUrl(bookmark->url)));
 	}
+
+	updateActions();
 }
 
 void BookmarksContentsWidget::updateActions()
@@ -356,43 +437,14 @@ void BookmarksContentsWidget::print(QPrinter *printer)
 	m_ui->bookmarksView->render(printer);
 }
 
-QStandardItem *BookmarksContentsWidget::findFolder(int folder, QStandardItem *item)
+QStandardItem *BookmarksContentsWidget::findFolder(int folder)
 {
 	if (folder == 0)
 	{
 		return m_model->invisibleRootItem();
 	}
 
-	if (!item)
-	{
-		item = m_model->invisibleRootItem();
-	}
-
-	for (int i = 0; i < item->rowCount(); ++i)
-	{
-		QStandardItem *child = item->child(i, 0);
-
-		if (!child)
-		{
-			continue;
-		}
-
-		BookmarkInformation *bookmark = static_cast<BookmarkInformation*>(child->data(Qt::UserRole).value<void*>());
-
-		if (bookmark && bookmark->type == FolderBookmark && bookmark->identifier == folder)
-		{
-			return child;
-		}
-
-		QStandardItem *result = findFolder(folder, child);
-
-		if (result)
-		{
-			return result;
-		}
-	}
-
-	return NULL;
+	return m_folders.value(folder, NULL);
 }
 
 QString BookmarksContentsWidget::getTitle() const
@@ -472,4 +524,48 @@ bool BookmarksContentsWidget::filterBookmarks(const QString &filter, QStandardIt
 	return found;
 }
 
+bool BookmarksContentsWidget::eventFilter(QObject *object, QEvent *event)
+{
+	if (object == m_ui->bookmarksView->viewport() && event->type() == QEvent::Drop)
+	{
+		QDropEvent *dropEvent = static_cast<QDropEvent*>(event);
+		BookmarkInformation *bookmark = static_cast<BookmarkInformation*>(m_ui->bookmarksView->currentIndex().data(Qt::UserRole).value<void*>());
+
+		if (bookmark && dropEvent->source() == m_ui->bookmarksView)
+		{
+			const QModelIndex index = m_ui->bookmarksView->indexAt(dropEvent->pos());
+			BookmarkInformation *target = static_cast<BookmarkInformation*>(index.data(Qt::UserRole).value<void*>());
+			int folder = 0;
+			int row = -1;
+
+			if (target)
+			{
+				const QRect rectangle = m_ui->bookmarksView->visualRect(index);
+
+				if (target->type == FolderBookmark && dropEvent->pos().y() > (rectangle.top() + (rectangle.height() / 4)) && dropEvent->pos().y() < (rectangle.bottom() - (rectangle.height() / 4)))
+				{
+					folder = target->identifier;
+				}
+				else
+				{
+					folder = target->parent;
+					row = (index.row() + ((dropEvent->pos().y() > rectangle.center().y()) ? 1 : 0));
+				}
+			}
+
+			if (target != bookmark)
+			{
+				BookmarksManager::moveBookmark(bookmark, folder, row);
+			}
+		}
+
+		dropEvent->setDropAction(Qt::IgnoreAction);
+		dropEvent->accept();
+
+		return true;
+	}
+
+	return ContentsWidget::eventFilter(object, event);
+}
+
 }
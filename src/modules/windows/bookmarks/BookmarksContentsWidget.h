@@ -52,11 +52,13 @@ public:
 protected:
 	void changeEvent(QEvent *event);
 	void gatherBookmarks(int folder);
-	QStandardItem* findFolder(int folder, QStandardItem *item = NULL);
+	void forgetFolders(BookmarkInformation *bookmark);
+	QStandardItem* findFolder(int folder);
 	int findFolder(const QModelIndex &index);
+	bool eventFilter(QObject *object, QEvent *event);
 
 protected slots:
-	void addBookmark(BookmarkInformation *bookmark, QStandardItem *parent = NULL);
+	void addBookmark(BookmarkInformation *bookmark, QStandardItem *parent = NULL, int row = -1);
 	void addBookmark();
 	void addFolder();
 	void addSeparator();
@@ -65,12 +67,16 @@ protected slots:
 	void copyBookmarkLink();
 	void bookmarkProperties();
 	void showContextMenu(const QPoint &point);
-	void updateFolder(int folder);
+	void insertBookmark(BookmarkInformation *bookmark, int folder, int row);
+	void takeBookmark(BookmarkInformation *bookmark, int folder, int row);
+	void moveBookmark(BookmarkInformation *bookmark, int previousFolder, int previousRow, int folder, int row);
+	void updateBookmark(BookmarkInformation *bookmark, int folder, int row);
 	void updateActions();
 	bool filterBookmarks(const QString &filter, QStandardItem *branch = NULL);
 
 private:
 	QStandardItemModel *m_model;
+	QHash<int, QStandardItem*> m_folders;
 	QList<QString> m_bookmarksToOpen;
 	QHash<WindowAction, QAction*> m_actions;
 	Ui::BookmarksContentsWidget *m_ui;
@@ -0,0 +1,431 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2013 - 2014 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "NetworkContentsWidget.h"
+#include "NetworkTimelineDelegate.h"
+#include "../../../core/ContentBlockingManager.h"
+#include "../../../core/NetworkAccessManager.h"
+#include "../../../core/PreconnectManager.h"
+#include "../../../core/PrefetchManager.h"
+#include "../../../core/SearchSuggester.h"
+#include "../../../core/SnapshotsManager.h"
+#include "../../../core/Utils.h"
+#include "../../../ui/ItemDelegate.h"
+
+#include "ui_NetworkContentsWidget.h"
+
+#include <QtCore/QDir>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QSaveFile>
+#include <QtCore/QTimerEvent>
+#include <QtCore/QUrlQuery>
+#include <QtWidgets/QApplication>
+#include <QtWidgets/QFileDialog>
+#include <QtWidgets/QMessageBox>
+
+namespace Otter
+{
+
+NetworkContentsWidget::NetworkContentsWidget(Window *window) : ContentsWidget(window),
+	m_model(new QStandardItemModel(this)),
+	m_updateTimer(0),
+	m_ui(new Ui::NetworkContentsWidget)
+{
+	m_ui->setupUi(this);
+
+	QStringList labels;
+	labels << tr("Address") << tr("Method") << tr("Status") << tr("Protocol") << tr("Type") << tr("Size") << tr("Start") << tr("Duration") << tr("Timeline");
+
+	m_model->setHorizontalHeaderLabels(labels);
+
+	m_ui->requestsView->setModel(m_model);
+	m_ui->requestsView->setItemDelegate(new ItemDelegate(this));
+	m_ui->requestsView->setItemDelegateForColumn(8, new NetworkTimelineDelegate(this));
+	m_ui->requestsView->header()->setTextElideMode(Qt::ElideRight);
+	m_ui->requestsView->header()->setSectionResizeMode(0, QHeaderView::Stretch);
+	m_ui->requestsView->header()->resizeSection(8, 200);
+
+	populateTabs();
+
+	connect(m_ui->tabsComboBox, SIGNAL(currentIndexChanged(int)), this, SLOT(selectTab(int)));
+	connect(m_ui->refreshButton, SIGNAL(clicked()), this, SLOT(populateTabs()));
+	connect(m_ui->clearButton, SIGNAL(clicked()), this, SLOT(clearRequests()));
+	connect(m_ui->exportButton, SIGNAL(clicked()), this, SLOT(exportHar()));
+}
+
+NetworkContentsWidget::~NetworkContentsWidget()
+{
+	delete m_ui;
+}
+
+void NetworkContentsWidget::changeEvent(QEvent *event)
+{
+	QWidget::changeEvent(event);
+
+	switch (event->type())
+	{
+		case QEvent::LanguageChange:
+			m_ui->retranslateUi(this);
+
+			break;
+		default:
+			break;
+	}
+}
+
+void NetworkContentsWidget::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() == m_updateTimer)
+	{
+		killTimer(m_updateTimer);
+
+		m_updateTimer = 0;
+
+		populateRequests();
+	}
+}
+
+void NetworkContentsWidget::print(QPrinter *printer)
+{
+	m_ui->requestsView->render(printer);
+}
+
+void NetworkContentsWidget::populateTabs()
+{
+	const QList<NetworkAccessManager*> managers = NetworkAccessManager::getManagers();
+	int currentIndex = 0;
+
+	m_ui->tabsComboBox->blockSignals(true);
+	m_ui->tabsComboBox->clear();
+
+	for (int i = 0; i < managers.count(); ++i)
+	{
+		ContentsWidget *widget = managers.at(i)->getWidget();
+
+		if (!widget || widget->isPrivate())
+		{
+			continue;
+		}
+
+		if (managers.at(i) == m_networkAccessManager)
+		{
+			currentIndex = m_ui->tabsComboBox->count();
+		}
+
+		m_ui->tabsComboBox->addItem(widget->getIcon(), (widget->getTitle().isEmpty() ? widget->getUrl().toString() : widget->getTitle()), QVariant::fromValue<void*>(managers.at(i)));
+	}
+
+	m_ui->tabsComboBox->blockSignals(false);
+
+	selectTab(currentIndex);
+}
+
+void NetworkContentsWidget::populateRequests()
+{
+	m_model->removeRows(0, m_model->rowCount());
+
+	m_ui->clearButton->setEnabled(!m_networkAccessManager.isNull());
+	m_ui->exportButton->setEnabled(!m_networkAccessManager.isNull());
+
+	if (!m_networkAccessManager)
+	{
+		m_ui->summaryLabel->clear();
+
+		return;
+	}
+
+	const QList<NetworkRequestRecord> records = m_networkAccessManager->getRecords();
+	const QDateTime currentTime = QDateTime::currentDateTime();
+	const QDateTime startTime = (records.isEmpty() ? currentTime : records.first().startTime);
+	QHash<QByteArray, int> protocols;
+	qint64 duration = 1;
+	qint64 bytesReceived = 0;
+	int reusedConnections = 0;
+
+	for (int i = 0; i < records.count(); ++i)
+	{
+		const qint64 finishTime = ((records.at(i).finishTime < 0) ? records.at(i).startTime.msecsTo(currentTime) : records.at(i).finishTime);
+
+		duration = qMax(duration, (startTime.msecsTo(records.at(i).startTime) + finishTime));
+		bytesReceived += records.at(i).bytesReceived;
+
+		if (!records.at(i).protocol.isEmpty())
+		{
+			++protocols[records.at(i).protocol];
+		}
+
+		if (records.at(i).isConnectionReused)
+		{
+			++reusedConnections;
+		}
+	}
+
+	for (int i = 0; i < records.count(); ++i)
+	{
+		const NetworkRequestRecord &record = records.at(i);
+		const qint64 start = startTime.msecsTo(record.startTime);
+		const qint64 finishTime = ((record.finishTime < 0) ? record.startTime.msecsTo(currentTime) : record.finishTime);
+		const qint64 headersTime = ((record.headersTime < 0) ? finishTime : record.headersTime);
+		QString status;
+
+		if (record.status > 0)
+		{
+			status = QString::number(record.status);
+		}
+		else
+		{
+			status = ((record.finishTime < 0) ? tr("Pending") : tr("Failed"));
+		}
+
+		if (record.isFromCache)
+		{
+			status = tr("%1 (cache)").arg(status);
+		}
+
+		QString type = record.mimeType;
+
+		if (type.isEmpty())
+		{
+			switch (record.type)
+			{
+				case NetworkAccessManager::DocumentRequest:
+					type = tr("Document");
+
+					break;
+				case NetworkAccessManager::StyleSheetRequest:
+					type = tr("Style sheet");
+
+					break;
+				case NetworkAccessManager::ScriptRequest:
+					type = tr("Script");
+
+					break;
+				case NetworkAccessManager::ImageRequest:
+					type = tr("Image");
+
+					break;
+				default:
+					type = tr("Other");
+
+					break;
+			}
+		}
+
+		QVariantList timeline;
+		timeline << ((start * 1.0) / duration) << (((start + headersTime) * 1.0) / duration) << (((start + finishTime) * 1.0) / duration);
+
+		QList<QStandardItem*> items;
+		items.append(new QStandardItem(record.url.toString()));
+		items[0]->setToolTip(record.url.toString());
+		items.append(new QStandardItem(QString(record.method)));
+		items.append(new QStandardItem(status));
+		items.append(new QStandardItem(QString(record.protocol)));
+		items.append(new QStandardItem(type));
+		items.append(new QStandardItem(Utils::formatUnit(record.bytesReceived)));
+		items.append(new QStandardItem(tr("%1 ms").arg(start)));
+		items.append(new QStandardItem((record.finishTime < 0) ? QString() : tr("%1 ms").arg(record.finishTime)));
+		items.append(new QStandardItem());
+		items[8]->setData(timeline, Qt::UserRole);
+		items[8]->setToolTip(tr("Encrypted: %1 ms\nHeaders: %2 ms\nFirst byte: %3 ms\nFinished: %4 ms").arg(record.encryptedTime).arg(record.headersTime).arg(record.firstByteTime).arg(record.finishTime));
+
+		m_model->appendRow(items);
+	}
+
+	const QVariantHash statistics = NetworkAccessManager::getStatistics();
+	const QVariantHash blockingStatistics = ContentBlockingManager::getStatistics();
+	const QVariantHash preconnectStatistics = PreconnectManager::getStatistics();
+	const QVariantHash prefetchStatistics = PrefetchManager::getStatistics();
+	const QVariantHash suggestionsStatistics = SearchSuggester::getStatistics();
+	const QVariantHash snapshotsStatistics = SnapshotsManager::getStatistics();
+
+	QStringList summary;
+	summary.append(tr("%n request(s), %1 received in %2 ms", "", records.count()).arg(Utils::formatUnit(bytesReceived)).arg(records.isEmpty() ? 0 : duration));
+	summary.append(tr("HTTP/1.1: %1, SPDY: %2, HTTP/2: %3, reused secure connections: %4").arg(protocols.value(QByteArray("http/1.1"))).arg(protocols.value(QByteArray("spdy/3"))).arg(protocols.value(QByteArray("h2"))).arg(reusedConnections));
+	summary.append(tr("All tabs: HTTP/1.1: %1, SPDY: %2, HTTP/2: %3, new secure connections: %4, reused secure connections: %5").arg(statistics.value(QLatin1String("http1Requests")).toInt()).arg(statistics.value(QLatin1String("spdyRequests")).toInt()).arg(statistics.value(QLatin1String("http2Requests")).toInt()).arg(statistics.value(QLatin1String("secureConnections")).toInt()).arg(statistics.value(QLatin1String("reusedSecureConnections")).toInt()));
+	summary.append(tr("Content blocking: rules: %1, hiding selectors: %2, checked requests: %3, blocked requests: %4").arg(blockingStatistics.value(QLatin1String("rules")).toInt()).arg(blockingStatistics.value(QLatin1String("selectors")).toInt()).arg(blockingStatistics.value(QLatin1String("checkedRequests")).toInt()).arg(blockingStatistics.value(QLatin1String("blockedRequests")).toInt()));
+	summary.append(tr("Preconnected hosts: %1, hits: %2, misses: %3, known hosts: %4").arg(preconnectStatistics.value(QLatin1String("preconnects")).toInt()).arg(preconnectStatistics.value(QLatin1String("hits")).toInt()).arg(preconnectStatistics.value(QLatin1String("misses")).toInt()).arg(preconnectStatistics.value(QLatin1String("hosts")).toInt()));
+	summary.append(tr("Prefetched pages: %1 (%2), hits: %3, misses: %4, expired: %5, hit rate: %6%").arg(prefetchStatistics.value(QLatin1String("prefetches")).toInt()).arg(Utils::formatUnit(prefetchStatistics.value(QLatin1String("bytes")).toLongLong())).arg(prefetchStatistics.value(QLatin1String("hits")).toInt()).arg(prefetchStatistics.value(QLatin1String("misses")).toInt()).arg(prefetchStatistics.value(QLatin1String("expired")).toInt()).arg(qRound(prefetchStatistics.value(QLatin1String("hitRate")).toDouble() * 100)));
+	summary.append(tr("Search suggestions: typed queries: %1, requests: %2, cache hits: %3, requests per typed character: %4").arg(suggestionsStatistics.value(QLatin1String("queries")).toInt()).arg(suggestionsStatistics.value(QLatin1String("requests")).toInt()).arg(suggestionsStatistics.value(QLatin1String("cacheHits")).toInt()).arg(suggestionsStatistics.value(QLatin1String("requestsPerQuery")).toDouble(), 0, 'f', 2));
+	summary.append(tr("Offline snapshots: %1, resources: %2 (%3), hits: %4, misses: %5").arg(snapshotsStatistics.value(QLatin1String("snapshots")).toInt()).arg(snapshotsStatistics.value(QLatin1String("resources")).toInt()).arg(Utils::formatUnit(snapshotsStatistics.value(QLatin1String("size")).toLongLong())).arg(snapshotsStatistics.value(QLatin1String("hits")).toInt()).arg(snapshotsStatistics.value(QLatin1String("misses")).toInt()));
+
+	m_ui->summaryLabel->setText(summary.join(QLatin1Char('\n')));
+}
+
+void NetworkContentsWidget::scheduleUpdate()
+{
+	if (m_updateTimer == 0)
+	{
+		m_updateTimer = startTimer(250);
+	}
+}
+
+void NetworkContentsWidget::selectTab(int index)
+{
+	if (m_networkAccessManager)
+	{
+		disconnect(m_networkAccessManager, SIGNAL(recordsChanged()), this, SLOT(scheduleUpdate()));
+	}
+
+	NetworkAccessManager *manager = static_cast<NetworkAccessManager*>(m_ui->tabsComboBox->itemData(index).value<void*>());
+
+	m_networkAccessManager = (NetworkAccessManager::getManagers().contains(manager) ? manager : NULL);
+
+	if (m_networkAccessManager)
+	{
+		connect(m_networkAccessManager, SIGNAL(recordsChanged()), this, SLOT(scheduleUpdate()));
+	}
+
+	populateRequests();
+}
+
+void NetworkContentsWidget::clearRequests()
+{
+	if (m_networkAccessManager)
+	{
+		m_networkAccessManager->clearRecords();
+	}
+}
+
+void NetworkContentsWidget::exportHar()
+{
+	if (!m_networkAccessManager)
+	{
+		return;
+	}
+
+	const QString path = QFileDialog::getSaveFileName(this, tr("Export HAR"), QDir::homePath() + QLatin1String("/network.har"), tr("HTTP Archive files (*.har);;All files (*)"));
+
+	if (path.isEmpty())
+	{
+		return;
+	}
+
+	const QList<NetworkRequestRecord> records = m_networkAccessManager->getRecords();
+	QJsonArray entries;
+
+	for (int i = 0; i < records.count(); ++i)
+	{
+		const NetworkRequestRecord &record = records.at(i);
+
+		if (record.finishTime < 0)
+		{
+			continue;
+		}
+
+		const qint64 headersTime = ((record.headersTime < 0) ? record.finishTime : record.headersTime);
+		QJsonArray queryString;
+		const QList<QPair<QString, QString> > queryItems = QUrlQuery(record.url).queryItems(QUrl::FullyDecoded);
+
+		for (int j = 0; j < queryItems.count(); ++j)
+		{
+			QJsonObject queryItem;
+			queryItem.insert(QLatin1String("name"), queryItems.at(j).first);
+			queryItem.insert(QLatin1String("value"), queryItems.at(j).second);
+
+			queryString.append(queryItem);
+		}
+
+		QJsonObject request;
+		request.insert(QLatin1String("method"), QString(record.method));
+		request.insert(QLatin1String("url"), record.url.toString());
+		request.insert(QLatin1String("httpVersion"), QString(record.protocol));
+		request.insert(QLatin1String("cookies"), QJsonArray());
+		request.insert(QLatin1String("headers"), QJsonArray());
+		request.insert(QLatin1String("queryString"), queryString);
+		request.insert(QLatin1String("headersSize"), -1);
+		request.insert(QLatin1String("bodySize"), -1);
+
+		QJsonObject content;
+		content.insert(QLatin1String("size"), record.bytesReceived);
+		content.insert(QLatin1String("mimeType"), record.mimeType);
+
+		QJsonObject response;
+		response.insert(QLatin1String("status"), record.status);
+		response.insert(QLatin1String("statusText"), QString());
+		response.insert(QLatin1String("httpVersion"), QString(record.protocol));
+		response.insert(QLatin1String("cookies"), QJsonArray());
+		response.insert(QLatin1String("headers"), QJsonArray());
+		response.insert(QLatin1String("content"), content);
+		response.insert(QLatin1String("redirectURL"), QString());
+		response.insert(QLatin1String("headersSize"), -1);
+		response.insert(QLatin1String("bodySize"), (record.isFromCache ? 0 : record.bytesReceived));
+
+		QJsonObject timings;
+		timings.insert(QLatin1String("blocked"), -1);
+		timings.insert(QLatin1String("dns"), -1);
+		timings.insert(QLatin1String("connect"), record.encryptedTime);
+		timings.insert(QLatin1String("ssl"), -1);
+		timings.insert(QLatin1String("send"), 0);
+		timings.insert(QLatin1String("wait"), (headersTime - qMax(qint64(0), record.encryptedTime)));
+		timings.insert(QLatin1String("receive"), (record.finishTime - headersTime));
+
+		QJsonObject entry;
+		entry.insert(QLatin1String("startedDateTime"), record.startTime.toUTC().toString(QLatin1String("yyyy-MM-ddTHH:mm:ss.zzzZ")));
+		entry.insert(QLatin1String("time"), record.finishTime);
+		entry.insert(QLatin1String("request"), request);
+		entry.insert(QLatin1String("response"), response);
+		entry.insert(QLatin1String("cache"), QJsonObject());
+		entry.insert(QLatin1String("timings"), timings);
+
+		entries.append(entry);
+	}
+
+	QJsonObject creator;
+	creator.insert(QLatin1String("name"), QApplication::applicationName());
+	creator.insert(QLatin1String("version"), QApplication::applicationVersion());
+
+	QJsonObject log;
+	log.insert(QLatin1String("version"), QLatin1String("1.2"));
+	log.insert(QLatin1String("creator"), creator);
+	log.insert(QLatin1String("entries"), entries);
+
+	QJsonObject document;
+	document.insert(QLatin1String("log"), log);
+
+	QSaveFile file(path);
+
+	if (!file.open(QIODevice::WriteOnly) || file.write(QJsonDocument(document).toJson()) < 0 || !file.commit())
+	{
+		QMessageBox::critical(this, tr("Error"), tr("Failed to save HAR file."), QMessageBox::Close);
+	}
+}
+
+QString NetworkContentsWidget::getTitle() const
+{
+	return tr("Network Inspector");
+}
+
+QLatin1String NetworkContentsWidget::getType() const
+{
+	return QLatin1String("network");
+}
+
+QUrl NetworkContentsWidget::getUrl() const
+{
+	return QUrl(QLatin1String("about:network"));
+}
+
+QIcon NetworkContentsWidget::getIcon() const
+{
+	return Utils::getIcon(QLatin1String("transfers"), false);
+}
+
+}
@@ -0,0 +1,74 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2013 - 2014 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#ifndef OTTER_NETWORKCONTENTSWIDGET_H
+#define OTTER_NETWORKCONTENTSWIDGET_H
+
+#include "../../../ui/ContentsWidget.h"
+
+#include <QtCore/QPointer>
+#include <QtGui/QStandardItemModel>
+
+namespace Otter
+{
+
+namespace Ui
+{
+	class NetworkContentsWidget;
+}
+
+class NetworkAccessManager;
+class Window;
+
+class NetworkContentsWidget : public ContentsWidget
+{
+	Q_OBJECT
+
+public:
+	explicit NetworkContentsWidget(Window *window);
+	~NetworkContentsWidget();
+
+	void print(QPrinter *printer);
+	QString getTitle() const;
+	QLatin1String getType() const;
+	QUrl getUrl() const;
+	QIcon getIcon() const;
+
+protected:
+	void changeEvent(QEvent *event);
+	void timerEvent(QTimerEvent *event);
+
+protected slots:
+	void populateTabs();
+	void populateRequests();
+	void scheduleUpdate();
+	void selectTab(int index);
+	void clearRequests();
+	void exportHar();
+
+private:
+	QPointer<NetworkAccessManager> m_networkAccessManager;
+	QStandardItemModel *m_model;
+	int m_updateTimer;
+	Ui::NetworkContentsWidget *m_ui;
+};
+
+}
+
+#endif
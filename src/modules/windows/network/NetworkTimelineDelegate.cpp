@@ -0,0 +1,61 @@
+/**************************************************************************
+* Otter Browser: Web browser controlled by the user, not vice-versa.
+* Copyright (C) 2013 - 2014 Michal Dutkiewicz aka Emdek <michal@emdek.pl>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+**************************************************************************/
+
+#include "NetworkTimelineDelegate.h"
+
+#include <QtGui/QPainter>
+#include <QtWidgets/QApplication>
+
+namespace Otter
+{
+
+NetworkTimelineDelegate::NetworkTimelineDelegate(QObject *parent) : QStyledItemDelegate(parent)
+{
+}
+
+void NetworkTimelineDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+	QApplication::style()->drawPrimitive(QStyle::PE_PanelItemViewItem, &option, painter, option.widget);
+
+	const QVariantList timeline = index.data(Qt::UserRole).toList();
+
+	if (timeline.count() < 3)
+	{
+		return;
+	}
+
+	const QRect rectangle = option.rect.adjusted(2, 3, -2, -3);
+	const int start = (rectangle.left() + (timeline.at(0).toReal() * rectangle.width()));
+	const int headers = (rectangle.left() + (timeline.at(1).toReal() * rectangle.width()));
+	const int finish = (rectangle.left() + (timeline.at(2).toReal() * rectangle.width()));
+	QColor waitingColor = option.palette.color(QPalette::Highlight);
+	waitingColor.setAlpha(100);
+
+	painter->save();
+
+	if (headers > start)
+	{
+		painter->fillRect(QRect(start, rectangle.top(), (headers - start), rectangle.height()), waitingColor);
+	}
+
+	painter->fillRect(QRect(qMax(start, headers), rectangle.top(), qMax(1, (finish - qMax(start, headers))), rectangle.height()), option.palette.color(QPalette::Highlight));
+	painter->restore();
+}
+
+}
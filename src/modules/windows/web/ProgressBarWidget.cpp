@@ -96,6 +96,26 @@ void ProgressBarWidget::timerEvent(QTimerEvent *event)
 	}
 }
 
+void ProgressBarWidget::showEvent(QShowEvent *event)
+{
+	if (m_webWidget)
+	{
+		m_webWidget->setLoadStatusUpdatesEnabled(true);
+	}
+
+	QFrame::showEvent(event);
+}
+
+void ProgressBarWidget::hideEvent(QHideEvent *event)
+{
+	if (m_webWidget)
+	{
+		m_webWidget->setLoadStatusUpdatesEnabled(false);
+	}
+
+	QFrame::hideEvent(event);
+}
+
 void ProgressBarWidget::updateLoadStatus(int finishedRequests, int startedReuests, qint64 bytesReceived, qint64 bytesTotal, qint64 speed)
 {
 	Q_UNUSED(bytesTotal)
@@ -20,6 +20,7 @@
 #ifndef OTTER_PROGRESSBARWIDGET_H
 #define OTTER_PROGRESSBARWIDGET_H
 
+#include <QtCore/QPointer>
 #include <QtCore/QTime>
 #include <QtWidgets/QFrame>
 #include <QtWidgets/QLabel>
@@ -39,13 +40,15 @@ public:
 
 protected:
 	void timerEvent(QTimerEvent *event);
+	void showEvent(QShowEvent *event);
+	void hideEvent(QHideEvent *event);
 
 protected slots:
 	void updateLoadStatus(int finishedRequests, int startedReuests, qint64 bytesReceived, qint64 bytesTotal, qint64 speed);
 	void setLoading(bool loading);
 
 private:
-	WebWidget *m_webWidget;
+	QPointer<WebWidget> m_webWidget;
 	QProgressBar *m_progressBar;
 	QLabel *m_elementsLabel;
 	QLabel *m_totalLabel;
@@ -20,6 +20,7 @@
 #include "WebContentsWidget.h"
 #include "ProgressBarWidget.h"
 #include "../../../core/SettingsManager.h"
+#include "../../../core/Utils.h"
 #include "../../../core/WebBackend.h"
 #include "../../../core/WebBackendsManager.h"
 #include "../../../ui/WebWidget.h"
@@ -29,26 +30,28 @@
 namespace Otter
 {
 
-WebContentsWidget::WebContentsWidget(bool privateWindow, WebWidget *widget, Window *window) : ContentsWidget(window),
-	m_webWidget(widget),
+WebContentsWidget::WebContentsWidget(bool privateWindow, WebWidget *widget, Window *window, bool suspended) : ContentsWidget(window),
+	m_webWidget(NULL),
 	m_progressBarWidget(NULL),
+	m_isPrivate(privateWindow),
 	m_showProgressBar(true),
 	m_ui(new Ui::WebContentsWidget)
 {
-	if (m_webWidget)
-	{
-		m_webWidget->setParent(this);
-	}
-	else
-	{
-		m_webWidget = WebBackendsManager::getBackend()->createWidget(privateWindow, this);
-	}
-
 	optionChanged("Browser/ShowDetailedProgressBar", SettingsManager::getValue("Browser/ShowDetailedProgressBar"));
 
 	m_ui->setupUi(this);
 	m_ui->findWidget->hide();
-	m_ui->verticalLayout->addWidget(m_webWidget);
+
+	if (widget)
+	{
+		widget->setParent(this);
+
+		setWebWidget(widget);
+	}
+	else if (!suspended)
+	{
+		setWebWidget(WebBackendsManager::getBackend()->createWidget(privateWindow, this));
+	}
 
 	connect(SettingsManager::getInstance(), SIGNAL(valueChanged(QString,QVariant)), this, SLOT(optionChanged(QString,QVariant)));
 	connect(m_ui->findLineEdit, SIGNAL(textChanged(QString)), this, SLOT(updateFind()));
@@ -57,18 +60,6 @@ WebContentsWidget::WebContentsWidget(bool privateWindow, WebWidget *widget, Wind
 	connect(m_ui->findNextButton, SIGNAL(clicked()), this, SLOT(updateFind()));
 	connect(m_ui->findPreviousButton, SIGNAL(clicked()), this, SLOT(updateFind()));
 	connect(m_ui->closeButton, SIGNAL(clicked()), m_ui->findWidget, SLOT(hide()));
-	connect(m_webWidget, SIGNAL(requestedAddBookmark(QUrl,QString)), this, SIGNAL(requestedAddBookmark(QUrl,QString)));
-	connect(m_webWidget, SIGNAL(requestedOpenUrl(QUrl,bool,bool)), this, SLOT(notifyRequestedOpenUrl(QUrl,bool,bool)));
-	connect(m_webWidget, SIGNAL(requestedNewWindow(WebWidget*)), this, SLOT(notifyRequestedNewWindow(WebWidget*)));
-	connect(m_webWidget, SIGNAL(requestedSearch(QString,QString)), this, SIGNAL(requestedSearch(QString,QString)));
-	connect(m_webWidget, SIGNAL(actionsChanged()), this, SIGNAL(actionsChanged()));
-	connect(m_webWidget, SIGNAL(statusMessageChanged(QString,int)), this, SIGNAL(statusMessageChanged(QString,int)));
-	connect(m_webWidget, SIGNAL(titleChanged(QString)), this, SIGNAL(titleChanged(QString)));
-	connect(m_webWidget, SIGNAL(urlChanged(QUrl)), this, SIGNAL(urlChanged(QUrl)));
-	connect(m_webWidget, SIGNAL(iconChanged(QIcon)), this, SIGNAL(iconChanged(QIcon)));
-	connect(m_webWidget, SIGNAL(loadingChanged(bool)), this, SIGNAL(loadingChanged(bool)));
-	connect(m_webWidget, SIGNAL(loadingChanged(bool)), this, SLOT(setLoading(bool)));
-	connect(m_webWidget, SIGNAL(zoomChanged(int)), this, SIGNAL(zoomChanged(int)));
 }
 
 WebContentsWidget::~WebContentsWidget()
@@ -109,10 +100,16 @@ void WebContentsWidget::optionChanged(const QString &option, const QVariant &val
 
 		if (!m_showProgressBar && m_progressBarWidget)
 		{
+			m_progressBarWidget->hide();
 			m_progressBarWidget->deleteLater();
 			m_progressBarWidget = NULL;
 		}
 
+		if (!m_webWidget)
+		{
+			return;
+		}
+
 		if (m_progressBarWidget)
 		{
 			connect(m_webWidget, SIGNAL(progressBarGeometryChanged()), this, SLOT(updateProgressBarWidget()));
@@ -126,17 +123,76 @@ void WebContentsWidget::optionChanged(const QString &option, const QVariant &val
 
 void WebContentsWidget::search(const QString &search, const QString &query)
 {
+	resume();
+
 	m_webWidget->search(search, query);
 }
 
 void WebContentsWidget::print(QPrinter *printer)
 {
+	resume();
+
 	m_webWidget->print(printer);
 }
 
+void WebContentsWidget::suspend()
+{
+	if (!m_webWidget)
+	{
+		return;
+	}
+
+	m_history = m_webWidget->getHistory();
+	m_thumbnail = m_webWidget->getThumbnail();
+
+	if (m_progressBarWidget)
+	{
+		m_progressBarWidget->deleteLater();
+		m_progressBarWidget = NULL;
+	}
+
+	m_ui->verticalLayout->removeWidget(m_webWidget);
+
+	m_webWidget->deleteLater();
+	m_webWidget = NULL;
+
+	emit suspendedChanged(true);
+	emit actionsChanged();
+}
+
+void WebContentsWidget::resume()
+{
+	if (m_webWidget)
+	{
+		return;
+	}
+
+	setWebWidget(WebBackendsManager::getBackend()->createWidget(m_isPrivate, this));
+
+	m_webWidget->setHistory(m_history);
+
+	m_history = WindowHistoryInformation();
+	m_thumbnail = QPixmap();
+
+	emit suspendedChanged(false);
+	emit actionsChanged();
+}
+
 void WebContentsWidget::goToHistoryIndex(int index)
 {
-	m_webWidget->goToHistoryIndex(index);
+	if (m_webWidget)
+	{
+		m_webWidget->goToHistoryIndex(index);
+
+		return;
+	}
+
+	if (index >= 0 && index < m_history.entries.count())
+	{
+		m_history.index = index;
+	}
+
+	resume();
 }
 
 void WebContentsWidget::triggerAction(WindowAction action, bool checked)
@@ -161,28 +217,92 @@ void WebContentsWidget::triggerAction(WindowAction action, bool checked)
 	}
 	else
 	{
+		resume();
+
 		m_webWidget->triggerAction(action, checked);
 	}
 }
 
 void WebContentsWidget::setDefaultTextEncoding(const QString &encoding)
 {
-	m_webWidget->setDefaultTextEncoding(encoding);
+	if (m_webWidget)
+	{
+		m_webWidget->setDefaultTextEncoding(encoding);
+	}
 }
 
 void WebContentsWidget::setHistory(const WindowHistoryInformation &history)
 {
-	m_webWidget->setHistory(history);
+	if (m_webWidget)
+	{
+		m_webWidget->setHistory(history);
+	}
+	else
+	{
+		m_history = history;
+
+		emit titleChanged(getTitle());
+		emit urlChanged(getUrl());
+		emit iconChanged(getIcon());
+	}
 }
 
 void WebContentsWidget::setZoom(int zoom)
 {
-	m_webWidget->setZoom(zoom);
+	if (m_webWidget)
+	{
+		m_webWidget->setZoom(zoom);
+	}
+	else if (m_history.index >= 0 && m_history.index < m_history.entries.count())
+	{
+		m_history.entries[m_history.index].zoom = zoom;
+
+		emit zoomChanged(zoom);
+	}
 }
 
 void WebContentsWidget::setUrl(const QUrl &url, bool typed)
 {
-	m_webWidget->setUrl(url, typed);
+	if (m_webWidget)
+	{
+		m_webWidget->setUrl(url, typed);
+
+		return;
+	}
+
+	WindowHistoryEntry entry;
+	entry.url = url.toString();
+
+	while (m_history.entries.count() > (m_history.index + 1))
+	{
+		m_history.entries.removeLast();
+	}
+
+	m_history.entries.append(entry);
+	m_history.index = (m_history.entries.count() - 1);
+
+	emit urlChanged(url);
+	emit titleChanged(getTitle());
+}
+
+void WebContentsWidget::setWebWidget(WebWidget *widget)
+{
+	m_webWidget = widget;
+
+	m_ui->verticalLayout->addWidget(m_webWidget);
+
+	connect(m_webWidget, SIGNAL(requestedAddBookmark(QUrl,QString)), this, SIGNAL(requestedAddBookmark(QUrl,QString)));
+	connect(m_webWidget, SIGNAL(requestedOpenUrl(QUrl,bool,bool)), this, SLOT(notifyRequestedOpenUrl(QUrl,bool,bool)));
+	connect(m_webWidget, SIGNAL(requestedNewWindow(WebWidget*)), this, SLOT(notifyRequestedNewWindow(WebWidget*)));
+	connect(m_webWidget, SIGNAL(requestedSearch(QString,QString)), this, SIGNAL(requestedSearch(QString,QString)));
+	connect(m_webWidget, SIGNAL(actionsChanged()), this, SIGNAL(actionsChanged()));
+	connect(m_webWidget, SIGNAL(statusMessageChanged(QString,int)), this, SIGNAL(statusMessageChanged(QString,int)));
+	connect(m_webWidget, SIGNAL(titleChanged(QString)), this, SIGNAL(titleChanged(QString)));
+	connect(m_webWidget, SIGNAL(urlChanged(QUrl)), this, SIGNAL(urlChanged(QUrl)));
+	connect(m_webWidget, SIGNAL(iconChanged(QIcon)), this, SIGNAL(iconChanged(QIcon)));
+	connect(m_webWidget, SIGNAL(loadingChanged(bool)), this, SIGNAL(loadingChanged(bool)));
+	connect(m_webWidget, SIGNAL(loadingChanged(bool)), this, SLOT(setLoading(bool)));
+	connect(m_webWidget, SIGNAL(zoomChanged(int)), this, SIGNAL(zoomChanged(int)));
 }
 
 void WebContentsWidget::notifyRequestedOpenUrl(const QUrl &url, bool background, bool newWindow)
@@ -197,6 +317,11 @@ void WebContentsWidget::notifyRequestedNewWindow(WebWidget *widget)
 
 void WebContentsWidget::updateFind(bool backwards)
 {
+	if (!m_webWidget)
+	{
+		return;
+	}
+
 	if (sender() && sender()->objectName() == QLatin1String("findPreviousButton"))
 	{
 		backwards = true;
@@ -241,6 +366,11 @@ void WebContentsWidget::updateFind(bool backwards)
 
 void WebContentsWidget::updateFindHighlight()
 {
+	if (!m_webWidget)
+	{
+		return;
+	}
+
 	FindFlags flags = NoFlagsFind;
 
 	if (m_ui->highlightButton->isChecked())
@@ -263,7 +393,7 @@ void WebContentsWidget::updateFindHighlight()
 
 void WebContentsWidget::updateProgressBarWidget()
 {
-	if (!m_progressBarWidget)
+	if (!m_progressBarWidget || !m_webWidget)
 	{
 		return;
 	}
@@ -295,27 +425,54 @@ WebContentsWidget* WebContentsWidget::clone(Window *parent)
 		return NULL;
 	}
 
+	if (!m_webWidget)
+	{
+		WebContentsWidget *widget = new WebContentsWidget(m_isPrivate, NULL, parent, true);
+		widget->setHistory(m_history);
+
+		return widget;
+	}
+
 	return new WebContentsWidget(m_webWidget->isPrivate(), m_webWidget->clone(), parent);
 }
 
 QAction* WebContentsWidget::getAction(WindowAction action)
 {
-	return m_webWidget->getAction(action);
+	return (m_webWidget ? m_webWidget->getAction(action) : NULL);
 }
 
 QUndoStack* WebContentsWidget::getUndoStack()
 {
-	return m_webWidget->getUndoStack();
+	return (m_webWidget ? m_webWidget->getUndoStack() : NULL);
 }
 
 QString WebContentsWidget::getDefaultTextEncoding() const
 {
-	return m_webWidget->getDefaultTextEncoding();
+	return (m_webWidget ? m_webWidget->getDefaultTextEncoding() : QString());
 }
 
 QString WebContentsWidget::getTitle() const
 {
-	return m_webWidget->getTitle();
+	if (m_webWidget)
+	{
+		return m_webWidget->getTitle();
+	}
+
+	const QString title = m_history.entries.value(m_history.index).title;
+
+	if (title.isEmpty())
+	{
+		const QUrl url = getUrl();
+
+		if (url.isEmpty() || (url.scheme() == QLatin1String("about") && (url.path().isEmpty() || url.path() == QLatin1String("blank"))))
+		{
+			return tr("New Tab");
+		}
+
+		return tr("(Untitled)");
+	}
+
+	return title;
 }
 
 QLatin1String WebContentsWidget::getType() const
@@ -325,27 +482,42 @@ QLatin1String WebContentsWidget::getType() const
 
 QUrl WebContentsWidget::getUrl() const
 {
-	return m_webWidget->getUrl();
+	return (m_webWidget ? m_webWidget->getUrl() : QUrl(m_history.entries.value(m_history.index).url));
 }
 
 QIcon WebContentsWidget::getIcon() const
 {
-	return m_webWidget->getIcon();
+	if (m_webWidget)
+	{
+		return m_webWidget->getIcon();
+	}
+
+	return (m_isPrivate ? Utils::getIcon(QLatin1String("tab-private")) : WebBackendsManager::getBackend()->getIconForUrl(getUrl()));
 }
 
 QPixmap WebContentsWidget::getThumbnail() const
 {
-	return m_webWidget->getThumbnail();
+	return (m_webWidget ? m_webWidget->getThumbnail() : m_thumbnail);
 }
 
 WindowHistoryInformation WebContentsWidget::getHistory() const
 {
-	return m_webWidget->getHistory();
+	return (m_webWidget ? m_webWidget->getHistory() : m_history);
+}
+
+qint64 WebContentsWidget::getMemoryUsage() const
+{
+	return (m_webWidget ? m_webWidget->getMemoryUsage() : 0);
 }
 
 int WebContentsWidget::getZoom() const
 {
-	return m_webWidget->getZoom();
+	if (m_webWidget)
+	{
+		return m_webWidget->getZoom();
+	}
+
+	return ((m_history.index >= 0 && m_history.index < m_history.entries.count()) ? m_history.entries.at(m_history.index).zoom : SettingsManager::getValue(QLatin1String("Content/DefaultZoom")).toInt());
 }
 
 bool WebContentsWidget::canClone() const
@@ -360,12 +532,17 @@ bool WebContentsWidget::canZoom() const
 
 bool WebContentsWidget::isLoading() const
 {
-	return m_webWidget->isLoading();
+	return (m_webWidget ? m_webWidget->isLoading() : false);
 }
 
 bool WebContentsWidget::isPrivate() const
 {
-	return m_webWidget->isPrivate();
+	return (m_webWidget ? m_webWidget->isPrivate() : m_isPrivate);
+}
+
+bool WebContentsWidget::isSuspended() const
+{
+	return (m_webWidget == NULL);
 }
 
 }
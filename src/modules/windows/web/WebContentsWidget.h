@@ -38,7 +38,7 @@ class WebContentsWidget : public ContentsWidget
 	Q_OBJECT
 
 public:
-	explicit WebContentsWidget(bool privateWindow, WebWidget *widget, Window *window);
+	explicit WebContentsWidget(bool privateWindow, WebWidget *widget, Window *window, bool suspended = false);
 	~WebContentsWidget();
 
 	void search(const QString &search, const QString &query);
@@ -53,13 +53,17 @@ public:
 	QIcon getIcon() const;
 	QPixmap getThumbnail() const;
 	WindowHistoryInformation getHistory() const;
+	qint64 getMemoryUsage() const;
 	int getZoom() const;
 	bool canClone() const;
 	bool canZoom() const;
 	bool isLoading() const;
 	bool isPrivate() const;
+	bool isSuspended() const;
 
 public slots:
+	void suspend();
+	void resume();
 	void goToHistoryIndex(int index);
 	void triggerAction(WindowAction action, bool checked = false);
 	void setDefaultTextEncoding(const QString &encoding);
@@ -70,6 +74,7 @@ public slots:
 protected:
 	void changeEvent(QEvent *event);
 	void resizeEvent(QResizeEvent *event);
+	void setWebWidget(WebWidget *widget);
 
 protected slots:
 	void optionChanged(const QString &option, const QVariant &value);
@@ -83,6 +88,9 @@ protected slots:
 private:
 	WebWidget *m_webWidget;
 	ProgressBarWidget *m_progressBarWidget;
+	WindowHistoryInformation m_history;
+	QPixmap m_thumbnail;
+	bool m_isPrivate;
 	bool m_showProgressBar;
 	Ui::WebContentsWidget *m_ui;
 };
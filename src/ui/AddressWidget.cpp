@@ -22,6 +22,7 @@
 #include "Window.h"
 #include "../core/AddressCompletionModel.h"
 #include "../core/BookmarksManager.h"
+#include "../core/PreconnectManager.h"
 #include "../core/SearchesManager.h"
 #include "../core/SettingsManager.h"
 #include "../core/Utils.h"
@@ -37,7 +38,8 @@ AddressWidget::AddressWidget(QWidget *parent) : QLineEdit(parent),
 	m_window(NULL),
 	m_completer(new QCompleter(AddressCompletionModel::getInstance(), this)),
 	m_bookmarkLabel(NULL),
-	m_urlIconLabel(NULL)
+	m_urlIconLabel(NULL),
+	m_urlFingerprint(0)
 {
 	m_completer->setCaseSensitivity(Qt::CaseInsensitive);
 	m_completer->setCompletionMode(QCompleter::InlineCompletion);
@@ -48,7 +50,9 @@ AddressWidget::AddressWidget(QWidget *parent) : QLineEdit(parent),
 	setCompleter(m_completer);
 
 	connect(this, SIGNAL(returnPressed()), this, SLOT(notifyRequestedLoadUrl()));
-	connect(BookmarksManager::getInstance(), SIGNAL(folderModified(int)), this, SLOT(updateBookmark()));
+	connect(this, SIGNAL(textEdited(QString)), this, SLOT(preconnect(QString)));
+	connect(BookmarksManager::getInstance(), SIGNAL(urlAdded(QString)), this, SLOT(updateBookmark()));
+	connect(BookmarksManager::getInstance(), SIGNAL(urlRemoved(QString)), this, SLOT(updateBookmark()));
 	connect(SettingsManager::getInstance(), SIGNAL(valueChanged(QString,QVariant)), this, SLOT(optionChanged(QString,QVariant)));
 }
 
@@ -146,6 +150,11 @@ void AddressWidget::notifyRequestedLoadUrl()
 	emit requestedLoadUrl(getUrl());
 }
 
+void AddressWidget::preconnect(const QString &text)
+{
+	PreconnectManager::predict(text, (m_window && m_window->isPrivate()));
+}
+
 void AddressWidget::updateBookmark()
 {
 	if (!m_bookmarkLabel)
@@ -153,9 +162,7 @@ void AddressWidget::updateBookmark()
 		return;
 	}
 
-	const QUrl url = getUrl();
-
-	if (url.scheme() == QLatin1String("about"))
+	if (m_urlFingerprint == 0)
 	{
 		m_bookmarkLabel->setEnabled(false);
 		m_bookmarkLabel->setPixmap(Utils::getIcon(QLatin1String("bookmarks")).pixmap(m_bookmarkLabel->size(), QIcon::Disabled));
@@ -164,7 +171,7 @@ void AddressWidget::updateBookmark()
 		return;
 	}
 
-	const bool hasBookmark = BookmarksManager::hasBookmark(url);
+	const bool hasBookmark = BookmarksManager::hasBookmark(m_urlFingerprint);
 
 	m_bookmarkLabel->setEnabled(true);
 	m_bookmarkLabel->setPixmap(Utils::getIcon(QLatin1String("bookmarks")).pixmap(m_bookmarkLabel->size(), (hasBookmark ? QIcon::Active : QIcon::Disabled)));
@@ -182,6 +189,9 @@ void AddressWidget::setIcon(const QIcon &icon)
 void AddressWidget::setUrl(const QUrl &url)
 {
 	setText((url.scheme() == QLatin1String("about") && url.path() == QLatin1String("blank")) ? QString() : url.toString());
+
+	m_urlFingerprint = ((url.scheme() == QLatin1String("about")) ? 0 : Utils::getUrlFingerprint(url));
+
 	updateBookmark();
 }
 
@@ -51,6 +51,7 @@ protected slots:
 	void removeIcon();
 	void optionChanged(const QString &option, const QVariant &value);
 	void notifyRequestedLoadUrl();
+	void preconnect(const QString &text);
 	void updateBookmark();
 	void setIcon(const QIcon &icon);
 
@@ -59,6 +60,7 @@ private:
 	QCompleter *m_completer;
 	QLabel *m_bookmarkLabel;
 	QLabel *m_urlIconLabel;
+	quint64 m_urlFingerprint;
 
 signals:
 	void requestedLoadUrl(QUrl url);
@@ -24,17 +24,14 @@
 namespace Otter
 {
 
-AuthenticationDialog::AuthenticationDialog(const QUrl &url, QAuthenticator *authenticator, QWidget *parent) : QDialog(parent),
-	m_authenticator(authenticator),
+AuthenticationDialog::AuthenticationDialog(const QUrl &url, const QAuthenticator &authenticator, QWidget *parent) : QDialog(parent),
 	m_ui(new Ui::AuthenticationDialog)
 {
 	m_ui->setupUi(this);
 	m_ui->serverValueLabel->setText(url.host());
-	m_ui->messageValueLabel->setText(authenticator->realm().toHtmlEscaped());
-	m_ui->userLineEdit->setText(authenticator->user());
-	m_ui->passwordLineEdit->setText(authenticator->password());
-
-	connect(this, SIGNAL(accepted()), this, SLOT(setup()));
+	m_ui->messageValueLabel->setText(authenticator.realm().toHtmlEscaped());
+	m_ui->userLineEdit->setText(authenticator.user());
+	m_ui->passwordLineEdit->setText(authenticator.password());
 }
 
 AuthenticationDialog::~AuthenticationDialog()
@@ -57,10 +54,14 @@ void AuthenticationDialog::changeEvent(QEvent *event)
 	}
 }
 
-void AuthenticationDialog::setup()
+QString AuthenticationDialog::getUser() const
+{
+	return m_ui->userLineEdit->text();
+}
+
+QString AuthenticationDialog::getPassword() const
 {
-	m_authenticator->setUser(m_ui->userLineEdit->text());
-	m_authenticator->setPassword(m_ui->passwordLineEdit->text());
+	return m_ui->passwordLineEdit->text();
 }
 
 }
@@ -37,17 +37,16 @@ class AuthenticationDialog : public QDialog
 	Q_OBJECT
 
 public:
-	explicit AuthenticationDialog(const QUrl &url, QAuthenticator *authenticator, QWidget *parent = NULL);
+	explicit AuthenticationDialog(const QUrl &url, const QAuthenticator &authenticator, QWidget *parent = NULL);
 	~AuthenticationDialog();
 
+	QString getUser() const;
+	QString getPassword() const;
+
 protected:
 	void changeEvent(QEvent *event);
 
-protected slots:
-	void setup();
-
 private:
-	QAuthenticator *m_authenticator;
 	Ui::AuthenticationDialog *m_ui;
 };
 
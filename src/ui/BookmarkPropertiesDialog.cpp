@@ -154,6 +154,19 @@ void BookmarkPropertiesDialog::saveBookmark()
 
 	if (m_bookmark->parent >= 0)
 	{
+		const int folder = m_ui->folderComboBox->view()->currentIndex().data(Qt::UserRole).toInt();
+
+		disconnect(BookmarksManager::getInstance(), SIGNAL(folderModified(int)), this, SLOT(reloadFolders()));
+
+		if (folder != m_bookmark->parent && !BookmarksManager::moveBookmark(m_bookmark, folder))
+		{
+			QMessageBox::critical(this, tr("Error"), tr("Failed to save bookmark."), QMessageBox::Close);
+
+			connect(BookmarksManager::getInstance(), SIGNAL(folderModified(int)), this, SLOT(reloadFolders()));
+
+			return;
+		}
+
 		BookmarksManager::updateBookmark(m_bookmark);
 	}
 	else
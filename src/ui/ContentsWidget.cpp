@@ -105,6 +105,14 @@ void ContentsWidget::hideDialog(QWidget *dialog)
 	}
 }
 
+void ContentsWidget::suspend()
+{
+}
+
+void ContentsWidget::resume()
+{
+}
+
 void ContentsWidget::goToHistoryIndex(int index)
 {
 	Q_UNUSED(index)
@@ -180,6 +188,11 @@ WindowHistoryInformation ContentsWidget::getHistory() const
 	return information;
 }
 
+qint64 ContentsWidget::getMemoryUsage() const
+{
+	return 0;
+}
+
 int ContentsWidget::getZoom() const
 {
 	return 100;
@@ -205,4 +218,9 @@ bool ContentsWidget::isPrivate() const
 	return false;
 }
 
+bool ContentsWidget::isSuspended() const
+{
+	return false;
+}
+
 }
@@ -45,15 +45,19 @@ public:
 	virtual QIcon getIcon() const = 0;
 	virtual QPixmap getThumbnail() const;
 	virtual WindowHistoryInformation getHistory() const;
+	virtual qint64 getMemoryUsage() const;
 	virtual int getZoom() const;
 	virtual bool canClone() const;
 	virtual bool canZoom() const;
 	virtual bool isLoading() const;
 	virtual bool isPrivate() const;
+	virtual bool isSuspended() const;
 
 public slots:
 	void showDialog(QWidget *dialog);
 	void hideDialog(QWidget *dialog);
+	virtual void suspend();
+	virtual void resume();
 	virtual void goToHistoryIndex(int index);
 	virtual void triggerAction(WindowAction action, bool checked = false);
 	virtual void setHistory(const WindowHistoryInformation &history);
@@ -83,6 +87,7 @@ signals:
 	void iconChanged(const QIcon &icon);
 	void loadingChanged(bool loading);
 	void zoomChanged(int zoom);
+	void suspendedChanged(bool suspended);
 };
 
 }
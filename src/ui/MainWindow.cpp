@@ -82,6 +82,7 @@ MainWindow::MainWindow(bool privateSession, const SessionEntry &windows, QWidget
 	ActionsManager::registerAction(this, QLatin1String("BookmarkLink"), tr("Bookmark Link..."), Utils::getIcon(QLatin1String("bookmark-new")));
 	ActionsManager::registerAction(this, QLatin1String("ReloadTime"), tr("Reload Each"));
 	ActionsManager::registerAction(this, QLatin1String("CopyAddress"), tr("Copy Address"));
+	ActionsManager::registerAction(this, QLatin1String("SaveForOffline"), tr("Keep Available Offline"));
 	ActionsManager::registerAction(this, QLatin1String("Validate"), tr("Validate"));
 	ActionsManager::registerAction(this, QLatin1String("ContentBlocking"), tr("Content Blocking..."));
 	ActionsManager::registerAction(this, QLatin1String("WebsitePreferences"), tr("Website Preferences..."));
@@ -189,6 +190,7 @@ MainWindow::MainWindow(bool privateSession, const SessionEntry &windows, QWidget
 	connect(m_ui->actionCloseTab, SIGNAL(triggered()), m_windowsManager, SLOT(close()));
 	connect(m_ui->actionSaveSession, SIGNAL(triggered()), this, SLOT(actionSaveSession()));
 	connect(m_ui->actionManageSessions, SIGNAL(triggered()), this, SLOT(actionManageSessions()));
+	connect(m_ui->actionImportBookmarks, SIGNAL(triggered()), this, SLOT(actionImportBookmarks()));
 	connect(m_ui->actionPrint, SIGNAL(triggered()), m_windowsManager, SLOT(print()));
 	connect(m_ui->actionPrintPreview, SIGNAL(triggered()), m_windowsManager, SLOT(printPreview()));
 	connect(m_ui->actionWorkOffline, SIGNAL(toggled(bool)), this, SLOT(actionWorkOffline(bool)));
@@ -229,8 +231,7 @@ MainWindow::MainWindow(bool privateSession, const SessionEntry &windows, QWidget
 	connect(m_ui->menuClosedWindows, SIGNAL(aboutToShow()), this, SLOT(menuClosedWindowsAboutToShow()));
 	connect(m_ui->menuBookmarks, SIGNAL(aboutToShow()), this, SLOT(menuBookmarksAboutToShow()));
 
-	m_windowsManager->restore(windows.windows);
-	m_windowsManager->setCurrentWindow(windows.index);
+	m_windowsManager->restore(windows);
 
 	SettingsManager::setDefaultValue(QLatin1String("Window/Size"), size());
 	SettingsManager::setDefaultValue(QLatin1String("Window/Position"), pos());
@@ -341,6 +342,8 @@ void MainWindow::closeEvent(QCloseEvent *event)
 		{
 			SessionsManager::saveSession();
 		}
+
+		SessionsManager::unregisterWindow(m_windowsManager);
 	}
 	else
 	{
@@ -415,6 +418,16 @@ void MainWindow::actionManageSessions()
 	dialog.exec();
 }
 
+void MainWindow::actionImportBookmarks()
+{
+	const QString path = QFileDialog::getOpenFileName(this, tr("Import Bookmarks"), QString(), tr("Bookmarks files (*.xbel *.html *.htm *.json);;All files (*)"));
+
+	if (!path.isEmpty())
+	{
+		BookmarksManager::importBookmarks(path);
+	}
+}
+
 void MainWindow::actionSession(QAction *action)
 {
 	if (!action->data().isNull())
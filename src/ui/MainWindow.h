@@ -63,6 +63,7 @@ protected slots:
 	void actionOpen();
 	void actionSaveSession();
 	void actionManageSessions();
+	void actionImportBookmarks();
 	void actionSession(QAction *action);
 	void actionWorkOffline(bool enabled);
 	void actionTextEncoding(QAction *action);
@@ -58,6 +58,16 @@ SearchWidget::SearchWidget(QWidget *parent) : QComboBox(parent),
 	connect(m_completer, SIGNAL(activated(QString)), this, SLOT(sendRequest(QString)));
 }
 
+void SearchWidget::focusInEvent(QFocusEvent *event)
+{
+	QComboBox::focusInEvent(event);
+
+	if (m_suggester)
+	{
+		m_suggester->preconnect();
+	}
+}
+
 void SearchWidget::wheelEvent(QWheelEvent *event)
 {
 	disconnect(lineEdit(), SIGNAL(textChanged(QString)), this, SLOT(queryChanged(QString)));
@@ -42,6 +42,7 @@ public slots:
 	void setCurrentSearchEngine(const QString &engine = QString());
 
 protected:
+	void focusInEvent(QFocusEvent *event);
 	void wheelEvent(QWheelEvent *event);
 
 protected slots:
@@ -48,6 +48,7 @@ void WebWidget::showContextMenu(const QPoint &position, MenuFlags flags)
 		menu.addSeparator();
 		menu.addAction(getAction(BookmarkAction));
 		menu.addAction(getAction(CopyAddressAction));
+		menu.addAction(getAction(SaveForOfflineAction));
 		menu.addAction(getAction(PrintAction));
 		menu.addSeparator();
 
@@ -75,6 +75,7 @@ public:
 	virtual QPixmap getThumbnail() = 0;
 	virtual QRect getProgressBarGeometry() const = 0;
 	virtual WindowHistoryInformation getHistory() const = 0;
+	virtual qint64 getMemoryUsage() const = 0;
 	virtual int getZoom() const = 0;
 	virtual bool isLoading() const = 0;
 	virtual bool isPrivate() const = 0;
@@ -85,6 +86,7 @@ public slots:
 	virtual void triggerAction(WindowAction action, bool checked = false) = 0;
 	virtual void setDefaultTextEncoding(const QString &encoding) = 0;
 	virtual void setHistory(const WindowHistoryInformation &history) = 0;
+	virtual void setLoadStatusUpdatesEnabled(bool enabled) = 0;
 	virtual void setZoom(int zoom) = 0;
 	virtual void setUrl(const QUrl &url, bool typed = true) = 0;
 	void showContextMenu(const QPoint &position, MenuFlags flags);
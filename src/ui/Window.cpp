@@ -26,6 +26,7 @@
 #include "../modules/windows/cookies/CookiesContentsWidget.h"
 #include "../modules/windows/configuration/ConfigurationContentsWidget.h"
 #include "../modules/windows/history/HistoryContentsWidget.h"
+#include "../modules/windows/network/NetworkContentsWidget.h"
 #include "../modules/windows/transfers/TransfersContentsWidget.h"
 #include "../modules/windows/web/WebContentsWidget.h"
 
@@ -165,6 +166,13 @@ void Window::updateGoForwardMenu()
 	}
 }
 
+void Window::updateNavigationActions()
+{
+	m_ui->backButton->setDefaultAction(m_contentsWidget->getAction(GoBackAction));
+	m_ui->forwardButton->setDefaultAction(m_contentsWidget->getAction(GoForwardAction));
+	m_ui->reloadOrStopButton->setDefaultAction(m_contentsWidget->getAction(ReloadOrStopAction));
+}
+
 void Window::setDefaultTextEncoding(const QString &encoding)
 {
 	if (m_contentsWidget->getType() == QLatin1String("web"))
@@ -216,6 +224,10 @@ void Window::setUrl(const QUrl &url)
 		{
 			newWidget = new HistoryContentsWidget(this);
 		}
+		else if (url.path() == QLatin1String("network"))
+		{
+			newWidget = new NetworkContentsWidget(this);
+		}
 		else if (url.path() == QLatin1String("transfers"))
 		{
 			newWidget = new TransfersContentsWidget(this);
@@ -288,12 +300,11 @@ void Window::setContentsWidget(ContentsWidget *widget)
 	layout()->addWidget(m_contentsWidget);
 
 	m_ui->navigationWidget->setVisible(m_contentsWidget->getType() == QLatin1String("web"));
-	m_ui->backButton->setDefaultAction(m_contentsWidget->getAction(GoBackAction));
-	m_ui->forwardButton->setDefaultAction(m_contentsWidget->getAction(GoForwardAction));
-	m_ui->reloadOrStopButton->setDefaultAction(m_contentsWidget->getAction(ReloadOrStopAction));
 	m_ui->addressWidget->setUrl(m_contentsWidget->getUrl());
 	m_ui->addressWidget->setFocus();
 
+	updateNavigationActions();
+
 	emit actionsChanged();
 	emit canZoomChanged(m_contentsWidget->canZoom());
 	emit titleChanged(m_contentsWidget->getTitle());
@@ -313,6 +324,7 @@ void Window::setContentsWidget(ContentsWidget *widget)
 	connect(m_contentsWidget, SIGNAL(loadingChanged(bool)), this, SIGNAL(loadingChanged(bool)));
 	connect(m_contentsWidget, SIGNAL(loadingChanged(bool)), this, SIGNAL(loadingChanged(bool)));
 	connect(m_contentsWidget, SIGNAL(zoomChanged(int)), this, SIGNAL(zoomChanged(int)));
+	connect(m_contentsWidget, SIGNAL(suspendedChanged(bool)), this, SLOT(updateNavigationActions()));
 }
 
 Window* Window::clone(QWidget *parent)
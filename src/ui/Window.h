@@ -83,6 +83,7 @@ enum WindowAction
 	BookmarkAction,
 	BookmarkLinkAction,
 	CopyAddressAction,
+	SaveForOfflineAction,
 	ViewSourceAction,
 	ViewSourceFrameAction,
 	ValidateAction,
@@ -158,6 +159,7 @@ protected slots:
 	void notifyRequestedOpenUrl(const QUrl &url, bool background, bool newWindow);
 	void updateGoBackMenu();
 	void updateGoForwardMenu();
+	void updateNavigationActions();
 
 private:
 	ContentsWidget *m_contentsWidget;